@@ -0,0 +1,139 @@
+#include <LaRoomyApi_STM32.h>
+
+// Check out the full documentation at: https://api.laroomy.com/
+
+// define the number of pixels of the strip (WS2812)
+#define STRIP_PIXEL_COUNT 60
+
+// define the control IDs - IMPORTANT: do not use zero as ID value and do not use an ID value more than once !!
+#define SP_RGB_SELECTOR_ID 1
+
+// the SPI bus of the strip, only MOSI (PC_3) is connected to the data input of the strip
+mbed::SPI stripSpi(PC_3, NC, PI_1);
+
+// the frame buffer of the strip (no memory is allocated by the output)
+static uint8_t stripFrame[LED_STRIP_FRAME_BUFFER_SIZE(STRIP_PIXEL_COUNT, LED_STRIP_WS2812)];
+
+// the strip output and the rgb control which renders into it
+LEDStripOutput stripOutput(&stripSpi, stripFrame, STRIP_PIXEL_COUNT);
+RGBControl rgbControl(stripOutput);
+
+// define the callback for the remote app-user events - https://api.laroomy.com/p/laroomy-app-callback.html
+class RemoteEvents : public ILaroomyAppCallback
+{
+public:
+    // receive rgb state notifications
+    void onRGBSelectorStateChanged(cID rgbSelectorID, const RGBSelectorState &state) override
+    {
+        rgbControl.applyStateChange(state);
+    }
+};
+
+// measure the rendering throughput of the strip output without SPI transfer
+void checkStripThroughput()
+{
+    static uint8_t testFrame[LED_STRIP_FRAME_BUFFER_SIZE(STRIP_PIXEL_COUNT, LED_STRIP_WS2812)];
+    LEDStripOutput testOutput(nullptr, testFrame, STRIP_PIXEL_COUNT);
+    testOutput.begin();
+
+    const unsigned long frames = 1000;
+    auto startFrames = testOutput.getFrameCount();
+    auto start = micros();
+
+    for (unsigned long i = 0; i < frames; i++)
+    {
+        // the color changes with every write, so every write renders a frame
+        testOutput.write((uint8_t)i, (uint8_t)(i >> 1), (uint8_t)(255 - i));
+    }
+    auto elapsed = micros() - start;
+
+    Serial.print("Strip rendering: ");
+    Serial.print(testOutput.getFrameCount() - startFrames);
+    Serial.print(" frames in ");
+    Serial.print(elapsed);
+    Serial.print(" us (");
+    Serial.print(elapsed / frames);
+    Serial.println(" us per frame)");
+}
+
+// count the output updates of a one second fade (polling mode) with the mock output
+void checkFadeUpdateRate()
+{
+    MockOutput mockOutput;
+    RGBControl testControl(mockOutput);
+
+    testControl.begin();
+    testControl.setFadeDelayValue(2);
+    testControl.setFadeDuration(1000);
+    mockOutput.resetWriteCount();
+
+    auto start = millis();
+    testControl.changeRGBColor(255, 128, 0);
+
+    // a stalled fade is stopped after 2 seconds
+    while (((mockOutput.red != 255) || (mockOutput.green != 128)) && ((millis() - start) < 2000))
+    {
+        testControl.onLoop();
+    }
+    auto elapsed = millis() - start;
+
+    Serial.print("Fade: ");
+    Serial.print(mockOutput.getWriteCount());
+    Serial.print(" updates in ");
+    Serial.print(elapsed);
+    Serial.println(" ms");
+
+    testControl.end();
+}
+
+void setup()
+{
+    // put your setup code here, to run once:
+
+    // monitor output for evaluation
+    Serial.begin(115200);
+
+    // check the output performance before the bluetooth setup
+    checkStripThroughput();
+    checkFadeUpdateRate();
+
+    // begin - https://api.laroomy.com/p/laroomy-api-class.html
+    LaRoomyApi.begin();
+
+    // set the bluetooth name
+    LaRoomyApi.setBluetoothName("Portenta H7");
+
+    // set device image
+    LaRoomyApi.setDeviceImage(LaRoomyImages::RGB_SLIDER_018);
+
+    // set the callback handler for remote events
+    LaRoomyApi.setCallbackInterface(
+        dynamic_cast<ILaroomyAppCallback *>(
+            new RemoteEvents()));
+
+    // create the rgb-property
+    RGBSelector rgbSelector;
+    rgbSelector.imageID = LaRoomyImages::RGB_FLOWER_020;
+    rgbSelector.rgbSelectorDescription = "Strip Color";
+    rgbSelector.rgbSelectorID = SP_RGB_SELECTOR_ID;
+
+    // add the rgb property
+    LaRoomyApi.addDeviceProperty(rgbSelector);
+
+    // finally call run to apply the setup and start bluetooth advertising
+    LaRoomyApi.run();
+
+    // begin rgb control (NOTE: the timer driven fading is not available with the strip output)
+    rgbControl.begin();
+}
+
+void loop()
+{
+    // put your main code here, to run repeatedly:
+
+    // the 'onLoop' method must be implemented here to permanently check for incoming transmissions
+    LaRoomyApi.onLoop();
+
+    // handle rgb control state changes and send the pending strip frames
+    rgbControl.onLoop();
+}
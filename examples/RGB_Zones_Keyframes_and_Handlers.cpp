@@ -0,0 +1,157 @@
+#include <LaRoomyApi_STM32.h>
+
+// Check out the full documentation at: https://api.laroomy.com/
+
+// define the pin names
+#define ZONE_1_RED_PIN 0
+#define ZONE_1_GREEN_PIN 1
+#define ZONE_1_BLUE_PIN 2
+#define ZONE_2_RED_PIN 3
+#define ZONE_2_GREEN_PIN 4
+#define ZONE_2_BLUE_PIN 5
+#define ACCENT_RED_PIN 6
+#define ACCENT_GREEN_PIN 7
+#define ACCENT_BLUE_PIN 8
+
+// define the control IDs - IMPORTANT: do not use zero as ID value and do not use an ID value more than once !!
+#define SP_ZONE_1_SELECTOR_ID 1
+#define SP_ZONE_2_SELECTOR_ID 2
+#define SP_SUNRISE_BUTTON_ID 3
+#define SP_ACCENT_SWITCH_ID 4
+#define SP_FADE_SPEED_SELECTOR_ID 5
+
+// the zones are driven by one object, the bound RGBSelectors are applied automatically
+RGBZoneControl zones;
+
+// the accent light runs the keyframe program
+RGBControl accentLight(ACCENT_RED_PIN, ACCENT_GREEN_PIN, ACCENT_BLUE_PIN);
+
+// the keyframe program: a sunrise (the array must remain valid while the program runs)
+static const RGBKEYFRAME sunrise[] = {
+    // red, green, blue, easing, fade time (ms), hold time (ms)
+    {40, 0, 10, FADE_EASE_IN, 2000, 500},
+    {255, 60, 0, FADE_EASE_IN_OUT, 4000, 1000},
+    {255, 160, 40, FADE_EASE_IN_OUT, 4000, 1000},
+    {255, 240, 200, FADE_EASE_OUT, 3000, 10000}
+};
+
+// the handler of the sunrise button, the context is the pointer passed on registration
+void onSunriseButton(cID buttonID, void *context)
+{
+    auto light = static_cast<RGBControl *>(context);
+
+    // run the program once, the color of the last keyframe remains
+    if (!light->runKeyframeProgram(sunrise, sizeof(sunrise) / sizeof(RGBKEYFRAME), 1))
+    {
+        Serial.println("The keyframe program was rejected.");
+    }
+}
+
+void setup()
+{
+    // put your setup code here, to run once:
+
+    // monitor output for evaluation
+    Serial.begin(115200);
+
+    // begin - https://api.laroomy.com/p/laroomy-api-class.html
+    LaRoomyApi.begin();
+
+    // set the bluetooth name
+    LaRoomyApi.setBluetoothName("Portenta H7");
+
+    // set device image
+    LaRoomyApi.setDeviceImage(LaRoomyImages::RGB_SLIDER_018);
+
+    // create one rgb-property per zone
+    RGBSelector zoneOneSelector;
+    zoneOneSelector.imageID = LaRoomyImages::RGB_FLOWER_020;
+    zoneOneSelector.rgbSelectorDescription = "Zone 1";
+    zoneOneSelector.rgbSelectorID = SP_ZONE_1_SELECTOR_ID;
+    LaRoomyApi.addDeviceProperty(zoneOneSelector);
+
+    RGBSelector zoneTwoSelector;
+    zoneTwoSelector.imageID = LaRoomyImages::RGB_FLOWER_020;
+    zoneTwoSelector.rgbSelectorDescription = "Zone 2";
+    zoneTwoSelector.rgbSelectorID = SP_ZONE_2_SELECTOR_ID;
+    LaRoomyApi.addDeviceProperty(zoneTwoSelector);
+
+    // create the controls of the accent light
+    Button sunriseButton;
+    sunriseButton.buttonID = SP_SUNRISE_BUTTON_ID;
+    sunriseButton.imageID = LaRoomyImages::LIGHT_BULB_004;
+    sunriseButton.buttonDescriptor = "Accent Light";
+    sunriseButton.buttonText = "Sunrise";
+    LaRoomyApi.addDeviceProperty(sunriseButton);
+
+    Switch accentSwitch;
+    accentSwitch.switchID = SP_ACCENT_SWITCH_ID;
+    accentSwitch.imageID = LaRoomyImages::LIGHT_BULB_004;
+    accentSwitch.switchDescription = "Accent Light On/Off";
+    accentSwitch.switchState = OFF;
+    LaRoomyApi.addDeviceProperty(accentSwitch);
+
+    LevelSelector fadeSpeedSelector;
+    fadeSpeedSelector.levelSelectorID = SP_FADE_SPEED_SELECTOR_ID;
+    fadeSpeedSelector.imageID = LaRoomyImages::LEVEL_ADJUST_043;
+    fadeSpeedSelector.levelSelectorDescription = "Zone Fade Duration";
+    fadeSpeedSelector.level = 40;
+    LaRoomyApi.addDeviceProperty(fadeSpeedSelector);
+
+    // register a handler per property instead of a callback interface (the properties must be added before)
+    LaRoomyApi.setPropertyHandler(SP_SUNRISE_BUTTON_ID, &onSunriseButton, &accentLight);
+
+    LaRoomyApi.setPropertyHandler(
+        SP_ACCENT_SWITCH_ID,
+        [](cID switchID, bool newState, void *context)
+        {
+            auto light = static_cast<RGBControl *>(context);
+            if (newState)
+            {
+                light->changeRGBColor(255, 240, 200);
+            }
+            else
+            {
+                // stops the keyframe program as well
+                light->off();
+            }
+        },
+        &accentLight);
+
+    LaRoomyApi.setPropertyHandler(
+        SP_FADE_SPEED_SELECTOR_ID,
+        [](cID selectorID, unsigned int newValue, void *context)
+        {
+            // 0 - 255 -> 0 - 5,1 seconds, takes effect with the next color change
+            static_cast<RGBZoneControl *>(context)->setFadeDuration((unsigned long)newValue * 20);
+        },
+        &zones);
+
+    // add the zones and bind them to the rgb-properties
+    zones.addZone(ZONE_1_RED_PIN, ZONE_1_GREEN_PIN, ZONE_1_BLUE_PIN, SP_ZONE_1_SELECTOR_ID);
+    zones.addZone(ZONE_2_RED_PIN, ZONE_2_GREEN_PIN, ZONE_2_BLUE_PIN, SP_ZONE_2_SELECTOR_ID);
+    zones.setFadeDuration(800);
+    zones.enableGammaCorrection(true);
+
+    // the remote state changes of the bound RGBSelectors are applied to the zones
+    LaRoomyApi.setRGBZoneControl(&zones);
+
+    // finally call run to apply the setup and start bluetooth advertising
+    LaRoomyApi.run();
+
+    // begin the rgb output
+    zones.begin();
+    accentLight.begin();
+}
+
+void loop()
+{
+    // put your main code here, to run repeatedly:
+
+    // the 'onLoop' method must be implemented here to permanently check for incoming transmissions
+    LaRoomyApi.onLoop();
+
+    // handle the fades of all zones and the keyframe program of the accent light
+    zones.onLoop();
+    accentLight.onLoop();
+}
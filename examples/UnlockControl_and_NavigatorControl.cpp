@@ -2,10 +2,10 @@
 #include <portentaLedColor.h>
 
 /**
- * NOTE:    In this example the 'PinStorageController' is used to handle the memory storage of
- *          the pin. But this class is a singleton instance and does not cover the case when there are more than
- *          one UnlockControl property. In this scenario the 'PinStorageController' is not suitable
- *          and a custom implementation of pin storage is necessary.
+ * NOTE:    In this example the internal pin handler is enabled with LaRoomyApi.enableInternalUnlockControlPinHandler(true),
+ *          so the pin of each UnlockControl property is verified and saved (as hash) internally. This covers more than
+ *          one UnlockControl property as well. (The 'PinStorageController' methods loadPin() and savePin(pin) handle
+ *          only one global pin, which must be set to the state and saved by the application.)
 */
 
 // Check out the full documentation at: https://api.laroomy.com/
@@ -70,14 +70,9 @@ public:
         else if (state.mode == UnlockControlModes::PIN_CHANGE_MODE)
         {
             // pin changes are handled internally, this callback only informes if the pin was changed
-            // NOTE: the pin must be saved permanently and must be reloaded on power-loss to remain consistent
+            // NOTE: the internal pin handler has already saved the new pin (as hash) to flash, the state holds no pin
             // https://api.laroomy.com/p/helper-classes.html#laroomyApiRefMIDPSCtrler
-
-            // save the pin
-            if (PinStorageController.savePin(state.pin))
-            {
-                Serial.println("Pin saved to flash!");
-            }
+            Serial.println("Pin changed!");
 
             // reset param
             unlockAttempts = 0;
@@ -207,10 +202,11 @@ void setup()
     uc.unlockControlID = SP_UNLOCK_CONTROL;
 
     /**
-     * Load the previously saved pin from flash or set a default pin if it wasn't saved before.
+     * Verify and save the pin internally, the pin of the state is not used. If no pin was saved before,
+     * the default pin UNLOCK_CONTROL_DEFAULT_PIN ("12345") is valid.
      * https://api.laroomy.com/p/helper-classes.html#laroomyApiRefMIDPSCtrler
      */
-    uc.unlockControlState.pin = PinStorageController.loadPin();
+    LaRoomyApi.enableInternalUnlockControlPinHandler(true);
     
     // add the property
     LaRoomyApi.addDeviceProperty(uc);
@@ -0,0 +1,81 @@
+/*
+    Host check of the SHA-256 implementation of the pin storage against the test vectors of FIPS 180-2 (appendix B).
+    The file is not part of the library build (the extras folder is not compiled by the Arduino IDE).
+
+    Build and run on the host (from this folder):
+
+        g++ -I../../src Sha256Test.cpp ../../src/Sha256.cpp -o sha256test && ./sha256test
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "Sha256.h"
+
+typedef struct _SHA256TESTVECTOR {
+    const char* message;
+    unsigned int repetitions;
+    uint8_t digest[SHA256_HASH_SIZE];
+} Sha256TestVector;
+
+static const Sha256TestVector testVectors[] = {
+    // B.1
+    {
+        "abc", 1,
+        {
+            0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+            0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+        }
+    },
+    // B.2 (two blocks)
+    {
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+        {
+            0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+            0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+        }
+    },
+    // B.3 (one million times 'a', hashed in parts)
+    {
+        "aaaaaaaaaa", 100000,
+        {
+            0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+            0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+        }
+    },
+    // the empty message
+    {
+        "", 1,
+        {
+            0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+            0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55
+        }
+    }
+};
+
+int main()
+{
+    unsigned int failed = 0;
+    unsigned int count = sizeof(testVectors) / sizeof(Sha256TestVector);
+
+    for(unsigned int i = 0; i < count; i++)
+    {
+        Sha256Context ctx;
+        uint8_t hash[SHA256_HASH_SIZE];
+
+        sha256Init(&ctx);
+        for(unsigned int r = 0; r < testVectors[i].repetitions; r++)
+        {
+            sha256Update(&ctx, (const uint8_t*)testVectors[i].message, strlen(testVectors[i].message));
+        }
+        sha256Final(&ctx, hash);
+
+        if(memcmp(hash, testVectors[i].digest, SHA256_HASH_SIZE) != 0)
+        {
+            printf("FAILED: test vector %u\n", i);
+            failed++;
+        }
+    }
+    printf("%u of %u test vectors passed\n", count - failed, count);
+
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+#include "AttemptThrottle.h"
+
+void AttemptThrottle::configure(unsigned long baseDelay, unsigned long maxDelay, unsigned int lockoutThreshold, unsigned long lockoutTime){
+    this->baseDelay = baseDelay;
+    this->maxDelay = maxDelay;
+    this->lockoutThreshold = lockoutThreshold;
+    this->lockoutTime = lockoutTime;
+}
+
+bool AttemptThrottle::isAttemptAllowed(){
+    return (this->getRemainingDelay() == 0) ? true : false;
+}
+
+void AttemptThrottle::onAttemptFailed(){
+    if(!this->loaded){
+        this->load();
+    }
+    if(this->failedAttempts < 0xFFFF){
+        this->failedAttempts++;
+    }
+    this->lastFailureTime = millis();
+
+    // write the counter lazily: every n-th failure and when the lockout starts
+    if(((this->failedAttempts % LAROOMY_THROTTLE_PERSIST_INTERVAL) == 0) || (this->failedAttempts == this->lockoutThreshold)){
+        this->store();
+    }
+}
+
+void AttemptThrottle::onAttemptSucceeded(){
+    if(!this->loaded){
+        this->load();
+    }
+    this->failedAttempts = 0;
+
+    // only a stored counter requires a flash write
+    if(this->storedFailedAttempts != 0){
+        this->store();
+    }
+}
+
+unsigned long AttemptThrottle::getRemainingDelay(){
+    if(!this->loaded){
+        this->load();
+    }
+    if(this->failedAttempts == 0){
+        return 0;
+    }
+    auto elapsed = millis() - this->lastFailureTime;
+    auto delay = this->getCurrentDelay();
+
+    return (elapsed < delay) ? (delay - elapsed) : 0;
+}
+
+unsigned int AttemptThrottle::getFailedAttempts(){
+    if(!this->loaded){
+        this->load();
+    }
+    return this->failedAttempts;
+}
+
+bool AttemptThrottle::isLockedOut(){
+    return ((this->lockoutThreshold > 0) && (this->getFailedAttempts() >= this->lockoutThreshold) && (this->getRemainingDelay() > 0))
+        ? true : false;
+}
+
+void AttemptThrottle::load(){
+    this->loaded = true;
+
+    uint16_t stored = 0;
+    size_t actual_size = 0;
+
+    if(FlashStorageManager.readData(this->storageKey, &stored, sizeof(stored), &actual_size) && (actual_size == sizeof(stored))){
+        this->failedAttempts = stored;
+        this->storedFailedAttempts = stored;
+    }
+    // the time of the failures before the reset is unknown, so the delay (or lockout) starts now
+    this->lastFailureTime = millis();
+}
+
+void AttemptThrottle::store(){
+    bool result;
+
+    if(this->failedAttempts == 0){
+        result = FlashStorageManager.eraseData(this->storageKey);
+    }
+    else {
+        uint16_t value = (uint16_t)this->failedAttempts;
+        result = FlashStorageManager.writeData(this->storageKey, &value, sizeof(value));
+    }
+    if(result){
+        this->storedFailedAttempts = this->failedAttempts;
+    }
+}
+
+unsigned long AttemptThrottle::getCurrentDelay(){
+    if((this->lockoutThreshold > 0) && (this->failedAttempts >= this->lockoutThreshold)){
+        // each failed attempt after the lockout restarts the lockout
+        return this->lockoutTime;
+    }
+    if(this->baseDelay == 0){
+        return 0;
+    }
+    // exponential back-off: base * 2^(failures - 1)
+    unsigned long delay = this->baseDelay;
+    for(unsigned int i = 1; i < this->failedAttempts; i++){
+        if(delay >= this->maxDelay){
+            break;
+        }
+        delay *= 2;
+    }
+    return (delay > this->maxDelay) ? this->maxDelay : delay;
+}
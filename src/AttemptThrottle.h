@@ -0,0 +1,98 @@
+#ifndef ATTEMPT_THROTTLE_H
+#define ATTEMPT_THROTTLE_H
+
+#include <Arduino.h>
+#include "flashStorageManager.h"
+
+// the delay in milliseconds after the first failed attempt, the delay is doubled with each further failed attempt
+#ifndef LAROOMY_THROTTLE_BASE_DELAY
+#define LAROOMY_THROTTLE_BASE_DELAY     500
+#endif
+
+// the maximum delay in milliseconds between two attempts
+#ifndef LAROOMY_THROTTLE_MAX_DELAY
+#define LAROOMY_THROTTLE_MAX_DELAY      30000
+#endif
+
+// the number of failed attempts (without a successful attempt in between) which cause a lockout
+#ifndef LAROOMY_THROTTLE_LOCKOUT_THRESHOLD
+#define LAROOMY_THROTTLE_LOCKOUT_THRESHOLD  10
+#endif
+
+// the duration of a lockout in milliseconds
+#ifndef LAROOMY_THROTTLE_LOCKOUT_TIME
+#define LAROOMY_THROTTLE_LOCKOUT_TIME   300000
+#endif
+
+// the failure counter is written to flash every n-th failed attempt (and when a lockout starts)
+#ifndef LAROOMY_THROTTLE_PERSIST_INTERVAL
+#define LAROOMY_THROTTLE_PERSIST_INTERVAL   4
+#endif
+
+/**
+ * @brief Throttling of authentication attempts (e.g. pin or key verification).
+ * After a failed attempt the next attempt is rejected until a delay has elapsed, the delay starts with the base delay and is doubled
+ * with each further failed attempt. If the number of failed attempts reaches the lockout threshold, all attempts are rejected for the lockout time.
+ * A successful attempt resets the counter. The counter is kept over reconnections and is stored in flash, so a reset of the device does not
+ * reset the lockout (after a reset the lockout time starts again). To avoid a flash write per attempt, the counter is only written every
+ * LAROOMY_THROTTLE_PERSIST_INTERVAL-th failed attempt, when a lockout starts and when a successful attempt clears a stored counter.
+ */
+class AttemptThrottle {
+public:
+    /**
+     * @brief Construct a throttle
+     * 
+     * @param storageKey The key to store the failure counter (e.g. FSTORAGE_KEY("my_throttle"))
+     */
+    AttemptThrottle(const FStorageKey& storageKey)
+        : storageKey(storageKey) {}
+
+    /**
+     * @brief Change the throttling parameter
+     * 
+     * @param baseDelay The delay in milliseconds after the first failed attempt (0 = no delay)
+     * @param maxDelay The maximum delay in milliseconds
+     * @param lockoutThreshold The number of failed attempts which cause a lockout (0 = no lockout)
+     * @param lockoutTime The duration of the lockout in milliseconds
+     */
+    void configure(unsigned long baseDelay, unsigned long maxDelay, unsigned int lockoutThreshold, unsigned long lockoutTime);
+
+    /**
+     * @brief Check if an attempt is allowed now. If not, the attempt must be rejected without evaluation.
+     * 
+     * @return bool - false if the delay after the last failed attempt or a lockout is running
+     */
+    bool isAttemptAllowed();
+
+    // report the result of an evaluated attempt
+    void onAttemptFailed();
+    void onAttemptSucceeded();
+
+    // the time in milliseconds until the next attempt is allowed
+    unsigned long getRemainingDelay();
+
+    // the number of failed attempts since the last successful attempt
+    unsigned int getFailedAttempts();
+
+    // check if the attempts are locked because the lockout threshold was reached
+    bool isLockedOut();
+
+private:
+    FStorageKey storageKey;
+
+    unsigned long baseDelay = LAROOMY_THROTTLE_BASE_DELAY;
+    unsigned long maxDelay = LAROOMY_THROTTLE_MAX_DELAY;
+    unsigned int lockoutThreshold = LAROOMY_THROTTLE_LOCKOUT_THRESHOLD;
+    unsigned long lockoutTime = LAROOMY_THROTTLE_LOCKOUT_TIME;
+
+    bool loaded = false;
+    unsigned int failedAttempts = 0;
+    unsigned int storedFailedAttempts = 0;
+    unsigned long lastFailureTime = 0;
+
+    void load();
+    void store();
+    unsigned long getCurrentDelay();
+};
+
+#endif // ATTEMPT_THROTTLE_H
@@ -0,0 +1,348 @@
+#include "LaRoomyApi_STM32.h"
+
+/*
+    Bluetooth lifecycle
+
+    The start, stop and restart of the bluetooth stack are executed as a state machine, one step per call of ble_processLifecycle()
+    (onLoop() or the protocol thread), so the device is never blocked while the stack settles:
+
+        STOPPED --(begin)--> STARTING --(service setup, advertise)--> ADVERTISING
+        ADVERTISING --(stop advertising, disconnect)--> STOPPING --(end)--> STOPPED
+
+    The transitions out of STOPPING and STOPPED wait for LAROOMY_BLE_SETTLE_TIME. The service and characteristic objects are created once
+    and registered again on each start, they are only re-created if an UUID was changed.
+
+    The bluetooth profile is applied in the same context: before advertising is started and, while advertising, when the selected
+    (or automatically selected) profile or its parameters have changed. ArduinoBLE cannot update the parameters of an open connection,
+    so the connection interval of a profile is only requested when the next connection is established. For that reason the automatic
+    selection keeps the profile of the last connection state after a disconnection instead of falling back to the balanced profile.
+*/
+
+#ifdef LAROOMY_STATIC_ALLOCATION
+alignas(BLEService) static uint8_t serviceStorage[sizeof(BLEService)];
+alignas(BLECharacteristic) static uint8_t txCharacteristicStorage[sizeof(BLECharacteristic)];
+alignas(BLECharacteristic) static uint8_t rxCharacteristicStorage[sizeof(BLECharacteristic)];
+#endif
+
+void LaRoomyAppImplementation::restartBluetooth(){
+    this->queueMutex.lock();
+    this->bleStartRequested = true;
+    this->bleRestartRequested = true;
+    this->bleRestartRequestTime = millis();
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::stopBluetooth(){
+    this->queueMutex.lock();
+    this->bleStartRequested = false;
+    this->bleRestartRequested = false;
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::startBluetooth(){
+    this->queueMutex.lock();
+    this->bleStartRequested = true;
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::getBluetoothLifecycleStatistics(BLELIFECYCLESTATISTICS& statistics){
+    this->queueMutex.lock();
+    statistics = this->bleStatistics;
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::resetBluetoothLifecycleStatistics(){
+    this->queueMutex.lock();
+    this->bleStatistics = {};
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::setBluetoothProfile(BLEProfile profile){
+    if(profile >= BLE_PROFILE_COUNT){
+        return;
+    }
+    this->queueMutex.lock();
+    this->selectedBleProfile = profile;
+    this->automaticBleProfile = false;
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::enableAutomaticBluetoothProfile(bool enable){
+    this->queueMutex.lock();
+    this->automaticBleProfile = enable;
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::setBluetoothProfileParameters(BLEProfile profile, const BLEPROFILEPARAMETERS& parameters){
+    if(profile >= BLE_PROFILE_COUNT){
+        return;
+    }
+    this->queueMutex.lock();
+    this->bleProfiles[profile] = parameters;
+    if(profile == this->activeBleProfile){
+        this->bleProfileChanged = true;
+    }
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::getBluetoothProfileParameters(BLEPROFILEPARAMETERS& parameters){
+    this->queueMutex.lock();
+    parameters = this->activeBleProfileParameters;
+    this->queueMutex.unlock();
+}
+
+bool LaRoomyAppImplementation::ble_createObjects(){
+    if(this->pService != nullptr){
+        return true;
+    }
+#ifdef LAROOMY_STATIC_ALLOCATION
+    this->pService = new (serviceStorage) BLEService(this->serviceUUID.c_str());
+    this->pTxCharacteristic =
+        new (txCharacteristicStorage) BLECharacteristic(this->txCharacteristicUUID.c_str(), BLERead | BLEWrite | BLENotify, 255);
+    this->pRxCharacteristic =
+        new (rxCharacteristicStorage) BLECharacteristic(this->rxCharacteristicUUID.c_str(), BLERead | BLEWrite | BLENotify, 255);
+#else
+    this->pService = new BLEService(this->serviceUUID.c_str());
+    this->pTxCharacteristic =
+        new BLECharacteristic(this->txCharacteristicUUID.c_str(), BLERead | BLEWrite | BLENotify, 255);
+    this->pRxCharacteristic =
+        new BLECharacteristic(this->rxCharacteristicUUID.c_str(), BLERead | BLEWrite | BLENotify, 255);
+
+    if(this->pService == nullptr || this->pTxCharacteristic == nullptr || this->pRxCharacteristic == nullptr){
+        this->ble_releaseObjects();
+
+        if(this->is_monitor_enabled){
+            Serial.println("ERROR: The bluetooth objects could not be created.");
+        }
+        return false;
+    }
+#endif
+    this->pRxCharacteristic->setEventHandler(BLEWritten, LaRoomyAppImplementation::characteristicWritten);
+
+    this->pService->addCharacteristic(*this->pTxCharacteristic);
+    this->pService->addCharacteristic(*this->pRxCharacteristic);
+
+    this->bleObjectsOutdated = false;
+    return true;
+}
+
+void LaRoomyAppImplementation::ble_releaseObjects(){
+#ifdef LAROOMY_STATIC_ALLOCATION
+    if(this->pService != nullptr){
+        this->pService->~BLEService();
+        this->pTxCharacteristic->~BLECharacteristic();
+        this->pRxCharacteristic->~BLECharacteristic();
+    }
+#else
+    delete this->pService;
+    delete this->pTxCharacteristic;
+    delete this->pRxCharacteristic;
+#endif
+    this->pService = nullptr;
+    this->pTxCharacteristic = nullptr;
+    this->pRxCharacteristic = nullptr;
+}
+
+void LaRoomyAppImplementation::ble_processLifecycle(){
+    auto now = millis();
+
+    // wait until the stack has settled
+    if((long)(now - this->bleStateDeadline) < 0){
+        return;
+    }
+    this->queueMutex.lock();
+    auto startRequested = this->bleStartRequested;
+    auto restartRequested = this->bleRestartRequested;
+    this->queueMutex.unlock();
+
+    switch(this->bleState){
+        case BLE_STATE_ADVERTISING:
+            if(!startRequested || restartRequested){
+                auto start = micros();
+                BLE.stopAdvertise();
+                if(this->is_connected){
+                    BLE.disconnect();
+                }
+                if(restartRequested){
+                    this->queueMutex.lock();
+                    this->bleRestartRequested = false;
+                    this->queueMutex.unlock();
+                    this->bleRestartPending = true;
+                }
+                this->ble_enterState(BLE_STATE_STOPPING, micros() - start);
+                this->bleStateDeadline = now + LAROOMY_BLE_SETTLE_TIME;
+            }
+            else {
+                auto profile = this->ble_selectProfile();
+                if((profile != this->activeBleProfile) || this->bleProfileChanged){
+                    this->ble_applyProfile(profile, true);
+                }
+            }
+            break;
+        case BLE_STATE_STOPPING:
+            {
+                auto start = micros();
+                BLE.end();
+                this->ble_enterState(BLE_STATE_STOPPED, micros() - start);
+                this->bleStateDeadline = now + LAROOMY_BLE_SETTLE_TIME;
+
+                // the stack does not report the disconnection anymore
+                if(this->is_connected){
+                    LaRoomyAppImplementation::disconnectHandler(BLEDevice());
+                }
+            }
+            break;
+        case BLE_STATE_STOPPED:
+            if(startRequested){
+                // the objects are not registered while the stack is stopped, so they can be replaced
+                if(this->bleObjectsOutdated){
+                    this->ble_releaseObjects();
+                }
+                if(!this->ble_createObjects()){
+                    this->bleStateDeadline = now + LAROOMY_BLE_SETTLE_TIME;
+                    break;
+                }
+                auto start = micros();
+                if(BLE.begin()){
+                    this->ble_enterState(BLE_STATE_STARTING, micros() - start);
+                }
+                else {
+                    // retry after the settle time
+                    this->bleStatistics.startFailureCount++;
+                    this->bleStateDeadline = now + LAROOMY_BLE_SETTLE_TIME;
+
+                    if(this->is_monitor_enabled){
+                        Serial.println("ERROR: The bluetooth stack could not be initialized.");
+                    }
+                }
+            }
+            else {
+                this->bleRestartPending = false;
+            }
+            break;
+        case BLE_STATE_STARTING:
+            if(!startRequested){
+                auto start = micros();
+                BLE.end();
+                this->ble_enterState(BLE_STATE_STOPPED, micros() - start);
+                this->bleStateDeadline = now + LAROOMY_BLE_SETTLE_TIME;
+            }
+            else {
+                auto start = micros();
+                auto name = this->getAdvertisedBluetoothName();
+
+                BLE.setLocalName(name.c_str());
+                BLE.setDeviceName(name.c_str());
+                BLE.setAdvertisedService(*this->pService);
+                BLE.addService(*this->pService);
+
+                BLE.setEventHandler(BLEConnected, LaRoomyAppImplementation::connectHandler);
+                BLE.setEventHandler(BLEDisconnected, LaRoomyAppImplementation::disconnectHandler);
+
+                this->ble_applyProfile(this->ble_selectProfile(), false);
+                BLE.advertise();
+                this->ble_enterState(BLE_STATE_ADVERTISING, micros() - start);
+
+                if(this->bleRestartPending){
+                    this->bleRestartPending = false;
+
+                    this->queueMutex.lock();
+                    auto restartDuration = millis() - this->bleRestartRequestTime;
+                    this->bleStatistics.restartCount++;
+                    this->bleStatistics.lastRestartDuration = restartDuration;
+                    if(restartDuration > this->bleStatistics.maxRestartDuration){
+                        this->bleStatistics.maxRestartDuration = restartDuration;
+                    }
+                    this->queueMutex.unlock();
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void LaRoomyAppImplementation::ble_enterState(BLELifecycleState state, unsigned long transitionTime){
+    auto now = millis();
+
+    this->queueMutex.lock();
+    this->bleStatistics.states[this->bleState].lastDuration = now - this->bleStateEntryTime;
+
+    auto timing = &this->bleStatistics.states[state];
+    timing->count++;
+    timing->lastTransitionTime = transitionTime;
+    if(transitionTime > timing->maxTransitionTime){
+        timing->maxTransitionTime = transitionTime;
+    }
+    this->queueMutex.unlock();
+
+    this->bleState = state;
+    this->bleStateEntryTime = now;
+
+    if(this->is_monitor_enabled){
+        Serial.print("Bluetooth state: ");
+        Serial.println((int)state);
+    }
+}
+
+BLEProfile LaRoomyAppImplementation::ble_selectProfile(){
+    this->queueMutex.lock();
+    auto automatic = this->automaticBleProfile;
+    auto profile = automatic ? this->activeBleProfile : this->selectedBleProfile;
+    this->queueMutex.unlock();
+
+    // while disconnected the automatic selection keeps the last profile, its connection interval is requested when the app reconnects
+    if(automatic && this->is_connected){
+        if(this->currentPropertyPageID != ID_DEVICE_MAIN_PAGE){
+            profile = BLE_PROFILE_LOW_LATENCY;
+        }
+        else {
+            profile = BLE_PROFILE_POWER_SAVING;
+        }
+    }
+    return profile;
+}
+
+void LaRoomyAppImplementation::ble_applyProfile(BLEProfile profile, bool restartAdvertising){
+    this->queueMutex.lock();
+    auto parameters = this->bleProfiles[profile];
+    this->bleProfileChanged = false;
+    this->queueMutex.unlock();
+
+    // the connection interval is requested by the stack when the next connection is established, an open connection keeps its interval
+    BLE.setConnectionInterval(parameters.minConnectionInterval, parameters.maxConnectionInterval);
+    BLE.setAdvertisingInterval(parameters.advertisingInterval);
+
+    // the advertising interval takes effect when advertising is started
+    if(restartAdvertising && !this->is_connected){
+        BLE.stopAdvertise();
+        BLE.advertise();
+    }
+    this->queueMutex.lock();
+    this->activeBleProfile = profile;
+    this->activeBleProfileParameters = parameters;
+    this->bleProfileChangeCount++;
+    this->queueMutex.unlock();
+
+    if(this->is_monitor_enabled){
+        Serial.print("Bluetooth profile: ");
+        Serial.print((int)profile);
+        Serial.print(" (advertising interval: ");
+        Serial.print(parameters.advertisingInterval);
+        Serial.print(", connection interval: ");
+        Serial.print(parameters.minConnectionInterval);
+        Serial.print(" - ");
+        Serial.print(parameters.maxConnectionInterval);
+        Serial.println(")");
+    }
+}
+
+void LaRoomyAppImplementation::ble_terminate(){
+    // called on destruction, the stack is stopped immediately
+    if(this->ble_isActive()){
+        BLE.stopAdvertise();
+        BLE.end();
+        this->bleState = BLE_STATE_STOPPED;
+    }
+    this->ble_releaseObjects();
+}
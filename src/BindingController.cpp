@@ -4,6 +4,11 @@
 #define DATA_KEY_BINDING_PASSKEY   "bndg_pkey"
 #define DATA_KEY_BINDING_REQUIRED   "bndg_reqr"
 
+// the binding data is stored in one record, the single keys above are only read to migrate data from older versions
+#define DATA_KEY_BINDING_RECORD     "bndg_rcrd"
+#define RECORD_VALUE_PASSKEY        "pkey"
+#define RECORD_VALUE_REQUIRED       "reqr"
+
 BindingController::BindingController(){
     this->init();
 }
@@ -17,7 +22,11 @@ BindingController* BindingController::GetInstance(){
         return bcInstance;
     }
     else {
+#ifdef LAROOMY_STATIC_ALLOCATION
+        bcInstance = new (instanceStorage) BindingController();
+#else
         bcInstance = new BindingController();
+#endif
         if(bcInstance != nullptr){
             bindingControllerInstanceCreated = true;
         }
@@ -27,18 +36,51 @@ BindingController* BindingController::GetInstance(){
 
 bool BindingController::bindingControllerInstanceCreated = false;
 BindingController* BindingController::bcInstance = nullptr;
+#ifdef LAROOMY_STATIC_ALLOCATION
+alignas(BindingController) uint8_t BindingController::instanceStorage[sizeof(BindingController)];
+#endif
 
 void BindingController::init(){
 
     this->bKey = "";
 
-    auto strReq = FlashStorageManager.readString(DATA_KEY_BINDING_PASSKEY);
-    if(strReq.length() > 0){
-        this->bKey = strReq;
+    FStorageRecord record;
+    if(FlashStorageManager.readRecord(DATA_KEY_BINDING_RECORD, record)){
+        this->bKey = record.readString(RECORD_VALUE_PASSKEY);
+        this->bRequired = (record.readUInt(RECORD_VALUE_REQUIRED) != 0) ? true : false;
+    }
+    else {
+        // no record, look for data in the previous format
+        auto strReq = FlashStorageManager.readString(DATA_KEY_BINDING_PASSKEY);
+        if(strReq.length() > 0){
+            this->bKey = strReq;
+        }
+
+        auto bndReq = FlashStorageManager.readUInt(DATA_KEY_BINDING_REQUIRED);
+        this->bRequired = (bndReq != 0) ? true : false;
+
+        if(this->bRequired || (this->bKey.length() > 0)){
+            // migrate to the record format
+            if(this->saveBindingData()){
+                FlashStorageManager.eraseData(DATA_KEY_BINDING_PASSKEY);
+                FlashStorageManager.eraseData(DATA_KEY_BINDING_REQUIRED);
+            }
+        }
     }
+}
 
-    auto bndReq = FlashStorageManager.readUInt(DATA_KEY_BINDING_REQUIRED);
-    this->bRequired = (bndReq != 0) ? true : false;
+bool BindingController::saveBindingData(){
+    // the key and the required-flag are written with one flash write, so they cannot get out of sync
+    FStorageRecord record;
+    if(!record.writeUInt(RECORD_VALUE_REQUIRED, this->bRequired ? 1 : 0)){
+        return false;
+    }
+    if(this->bKey.length() > 0){
+        if(!record.writeString(RECORD_VALUE_PASSKEY, this->bKey)){
+            return false;
+        }
+    }
+    return FlashStorageManager.writeRecord(DATA_KEY_BINDING_RECORD, record);
 }
 
 BindingResponseType BindingController::handleBindingTransmission(BindingTransmissionTypes bType, const String& key){
@@ -60,9 +102,8 @@ BindingResponseType BindingController::handleBindingTransmission(BindingTransmis
                 this->bKey = key;
                 this->bRequired = true;
 
-                // write data to flash                
-                FlashStorageManager.writeUInt(DATA_KEY_BINDING_REQUIRED, 1);
-                FlashStorageManager.writeString(DATA_KEY_BINDING_PASSKEY, key);
+                // write data to flash
+                this->saveBindingData();
 
                 // report success
                 return BindingResponseType::BINDING_ENABLE_SUCCESS;
@@ -76,9 +117,8 @@ BindingResponseType BindingController::handleBindingTransmission(BindingTransmis
                 this->bKey = "";
                 this->bRequired = false;
 
-                // write data                
-                FlashStorageManager.writeUInt(DATA_KEY_BINDING_REQUIRED, 0);
-                FlashStorageManager.eraseData(DATA_KEY_BINDING_PASSKEY);
+                // write data
+                this->saveBindingData();
 
                 // report release success
             }
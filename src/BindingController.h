@@ -2,6 +2,7 @@
 #define BINDING_CONTROLLER_H
 
 #include "constDef.h"
+#include "memoryConfig.h"
 #include <Arduino.h>
 
 /**
@@ -45,10 +46,14 @@ private:
 
     static bool bindingControllerInstanceCreated;
     static BindingController* bcInstance;    
+#ifdef LAROOMY_STATIC_ALLOCATION
+    static uint8_t instanceStorage[];
+#endif
 
     BindingController();
 
     void init();
+    bool saveBindingData();
 };
 
 /**
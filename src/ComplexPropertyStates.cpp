@@ -120,7 +120,7 @@ RGBSelectorState& RGBSelectorState::operator= (const COLOR& col)
     return *this;
 }
 
-bool RGBSelectorState::operator== (const RGBSelectorState& state){
+bool RGBSelectorState::operator== (const RGBSelectorState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->isOn == state.isOn)&&(this->flags == state.flags)
         &&(this->colorTransitionProgram == state.colorTransitionProgram)
         &&(this->redValue == state.redValue)&&(this->greenValue == state.greenValue)
@@ -132,7 +132,7 @@ bool RGBSelectorState::operator== (const RGBSelectorState& state){
     }
 }
 
-bool RGBSelectorState::operator!= (const RGBSelectorState& state){
+bool RGBSelectorState::operator!= (const RGBSelectorState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -147,6 +147,29 @@ void RGBSelectorState::copy(const RGBSelectorState& s){
     this->transitionType = s.transitionType;
 }
 
+uint8_t RGBSelectorState::toBinary(uint8_t* buffer) const {
+    buffer[0] = this->isOn ? 1 : 0;
+    buffer[1] = (uint8_t)this->colorTransitionProgram;
+    buffer[2] = (uint8_t)this->redValue;
+    buffer[3] = (uint8_t)this->greenValue;
+    buffer[4] = (uint8_t)this->blueValue;
+    buffer[5] = (uint8_t)this->transitionType;
+    return 6;
+}
+
+bool RGBSelectorState::fromBinary(const uint8_t* data, uint8_t size){
+    if(size < 6){
+        return false;
+    }
+    this->isOn = (data[0] != 0);
+    this->colorTransitionProgram = (RGBColorTransitionProgram)data[1];
+    this->redValue = data[2];
+    this->greenValue = data[3];
+    this->blueValue = data[4];
+    this->transitionType = (data[5] == 0) ? RGBTransitionType::SOFT_TRANSITION : RGBTransitionType::HARD_TRANSITION;
+    return true;
+}
+
 // Extended Level Selector State *************************************************************************************************
 
 String ExtendedLevelSelectorState::toStateString(unsigned int propertyIndex, TransmissionSubType t){
@@ -314,7 +337,7 @@ ExtendedLevelSelectorState& ExtendedLevelSelectorState::operator=(const Extended
     return *this;
 }
 
-bool ExtendedLevelSelectorState::operator==(const ExtendedLevelSelectorState& state){
+bool ExtendedLevelSelectorState::operator==(const ExtendedLevelSelectorState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->isOn == state.isOn)&&(this->levelValue == state.levelValue)){
         return true;
     }
@@ -323,7 +346,7 @@ bool ExtendedLevelSelectorState::operator==(const ExtendedLevelSelectorState& st
     }
 }
 
-bool ExtendedLevelSelectorState::operator!=(const ExtendedLevelSelectorState& state){
+bool ExtendedLevelSelectorState::operator!=(const ExtendedLevelSelectorState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -338,6 +361,31 @@ void ExtendedLevelSelectorState::copy(const ExtendedLevelSelectorState& state){
     this->trackingType = state.trackingType;
 }
 
+uint8_t ExtendedLevelSelectorState::toBinary(uint8_t* buffer) const {
+    // only the user-controlled values, the range and the appearance are defined by the property
+    buffer[0] = this->isOn ? 1 : 0;
+    buffer[1] = (uint8_t)(this->levelValue & 0xFF);
+    buffer[2] = (uint8_t)((this->levelValue >> 8) & 0xFF);
+    return 3;
+}
+
+bool ExtendedLevelSelectorState::fromBinary(const uint8_t* data, uint8_t size){
+    if(size < 3){
+        return false;
+    }
+    this->isOn = (data[0] != 0);
+    this->levelValue = (int16_t)(data[1] | (data[2] << 8));
+
+    // the range could have been changed since the snapshot was written
+    if(this->levelValue > this->maxValue){
+        this->levelValue = this->maxValue;
+    }
+    if(this->levelValue < this->minValue){
+        this->levelValue = this->minValue;
+    }
+    return true;
+}
+
 // Time selector state ***************************************************************************************************************
 
 String TimeSelectorState::toStateString(unsigned int propertyIndex, TransmissionSubType t){
@@ -394,7 +442,7 @@ void TimeSelectorState::fromExecutionString(const String& data){
     }
 }
 
-STATETIME TimeSelectorState::toStateTime(){
+STATETIME TimeSelectorState::toStateTime() const {
     STATETIME time;
     time.hour = this->hour;
     time.minute = this->minute;
@@ -406,7 +454,7 @@ TimeSelectorState& TimeSelectorState::operator=(const TimeSelectorState& state){
     return *this;
 }
 
-bool TimeSelectorState::operator==(const TimeSelectorState& state){
+bool TimeSelectorState::operator==(const TimeSelectorState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->hour == state.hour)&&(this->minute == state.minute)){
         return true;
     }
@@ -415,7 +463,7 @@ bool TimeSelectorState::operator==(const TimeSelectorState& state){
     }
 }
 
-bool TimeSelectorState::operator!=(const TimeSelectorState& state){
+bool TimeSelectorState::operator!=(const TimeSelectorState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -425,6 +473,21 @@ void TimeSelectorState::copy(const TimeSelectorState& state){
     this->minute = state.minute;
 }
 
+uint8_t TimeSelectorState::toBinary(uint8_t* buffer) const {
+    buffer[0] = (uint8_t)this->hour;
+    buffer[1] = (uint8_t)this->minute;
+    return 2;
+}
+
+bool TimeSelectorState::fromBinary(const uint8_t* data, uint8_t size){
+    if((size < 2) || (data[0] > 23) || (data[1] > 59)){
+        return false;
+    }
+    this->hour = data[0];
+    this->minute = data[1];
+    return true;
+}
+
 // Timeframe selector state ***********************************************************************************
 
 String TimeFrameSelectorState::toStateString(unsigned int propertyIndex, TransmissionSubType t){
@@ -497,7 +560,7 @@ void TimeFrameSelectorState::fromExecutionString(const String& data){
     }
 }
 
-bool TimeFrameSelectorState::checkIfTimeIsInFrame(const STATETIME& pTime){
+bool TimeFrameSelectorState::checkIfTimeIsInFrame(const STATETIME& pTime) const {
 
     // at first, 3 possibilites
     // 1. start-time is lower end-time (time-frame within one day)
@@ -542,7 +605,7 @@ TimeFrameSelectorState& TimeFrameSelectorState::operator=(const TimeFrameSelecto
     return *this;
 }
 
-bool TimeFrameSelectorState::operator==(const TimeFrameSelectorState& state){
+bool TimeFrameSelectorState::operator==(const TimeFrameSelectorState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->startTime == state.startTime)
         &&(this->endTime == state.endTime)){
             return true;
@@ -552,7 +615,7 @@ bool TimeFrameSelectorState::operator==(const TimeFrameSelectorState& state){
     }
 }
 
-bool TimeFrameSelectorState::operator!=(const TimeFrameSelectorState& state){
+bool TimeFrameSelectorState::operator!=(const TimeFrameSelectorState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -562,6 +625,25 @@ void TimeFrameSelectorState::copy(const TimeFrameSelectorState& state){
     this->endTime = state.endTime;
 }
 
+uint8_t TimeFrameSelectorState::toBinary(uint8_t* buffer) const {
+    buffer[0] = (uint8_t)this->startTime.hour;
+    buffer[1] = (uint8_t)this->startTime.minute;
+    buffer[2] = (uint8_t)this->endTime.hour;
+    buffer[3] = (uint8_t)this->endTime.minute;
+    return 4;
+}
+
+bool TimeFrameSelectorState::fromBinary(const uint8_t* data, uint8_t size){
+    if((size < 4) || (data[0] > 23) || (data[1] > 59) || (data[2] > 23) || (data[3] > 59)){
+        return false;
+    }
+    this->startTime.hour = data[0];
+    this->startTime.minute = data[1];
+    this->endTime.hour = data[2];
+    this->endTime.minute = data[3];
+    return true;
+}
+
 // Date Selector State ************************************************************************
 
 DateSelectorState& DateSelectorState::operator=(const DateSelectorState& state)
@@ -570,7 +652,7 @@ DateSelectorState& DateSelectorState::operator=(const DateSelectorState& state)
     return *this;
 }
 
-bool DateSelectorState::operator==(const DateSelectorState& state)
+bool DateSelectorState::operator==(const DateSelectorState& state) const
 {
     if((this->day == state.day)&&(this->month == state.month)&&(this->year == state.year)){
         return true;
@@ -579,7 +661,7 @@ bool DateSelectorState::operator==(const DateSelectorState& state)
     }
 }
 
-bool DateSelectorState::operator!=(const DateSelectorState& state)
+bool DateSelectorState::operator!=(const DateSelectorState& state) const
 {
     return (*this == state) ? false : true;
 }
@@ -662,6 +744,27 @@ void DateSelectorState::copy(const DateSelectorState& state)
     this->year = state.year;
 }
 
+uint8_t DateSelectorState::toBinary(uint8_t* buffer) const
+{
+    buffer[0] = (uint8_t)this->day;
+    buffer[1] = (uint8_t)this->month;
+    buffer[2] = (uint8_t)(this->year & 0xFF);
+    buffer[3] = (uint8_t)((this->year >> 8) & 0xFF);
+    return 4;
+}
+
+bool DateSelectorState::fromBinary(const uint8_t* data, uint8_t size)
+{
+    if((size < 4) || (data[0] < 1) || (data[0] > 31) || (data[1] < 1) || (data[1] > 12))
+    {
+        return false;
+    }
+    this->day = data[0];
+    this->month = data[1];
+    this->year = data[2] | (data[3] << 8);
+    return true;
+}
+
 // Unlock control state ***********************************************************************
 
 String UnlockControlState::toStateString(unsigned int propertyIndex, TransmissionSubType t){
@@ -771,7 +874,7 @@ UnlockControlState& UnlockControlState::operator=(const UnlockControlState& stat
     return *this;
 }
 
-bool UnlockControlState::operator==(const UnlockControlState& state){
+bool UnlockControlState::operator==(const UnlockControlState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->mode == state.mode)&&(this->flags == state.flags)
         &&(this->unlocked == state.unlocked)&&(this->pin == state.pin)){
             return true;
@@ -781,7 +884,7 @@ bool UnlockControlState::operator==(const UnlockControlState& state){
     }
 }
 
-bool UnlockControlState::operator!=(const UnlockControlState& state){
+bool UnlockControlState::operator!=(const UnlockControlState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -819,7 +922,7 @@ NavigatorState& NavigatorState::operator=(const NavigatorState& state){
     return *this;
 }
 
-bool NavigatorState::operator==(const NavigatorState& state){
+bool NavigatorState::operator==(const NavigatorState& state) const {
     if((this->visibilityFlags == state.visibilityFlags)&&(this->associatedPropertyID == state.associatedPropertyID)){
         return true;
     }
@@ -828,7 +931,7 @@ bool NavigatorState::operator==(const NavigatorState& state){
     }
 }
 
-bool NavigatorState::operator!=(const NavigatorState& state){
+bool NavigatorState::operator!=(const NavigatorState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -917,14 +1020,14 @@ BarGraphState&  BarGraphState::operator=(const BarGraphState& state){
     return *this;
 }
 
-bool BarGraphState::operator==(const BarGraphState& state){
+bool BarGraphState::operator==(const BarGraphState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->fixedMaximumValue == state.fixedMaximumValue)
         && (this->useFixedMaximumValue == state.useFixedMaximumValue)&&(this->useValueAsBarDescriptor == state.useValueAsBarDescriptor)
         && (this->barDataList.GetCount() == state.barDataList.GetCount()))
     {
         for(unsigned int i = 0; i < this->barDataList.GetCount(); i++){
-            if((this->barDataList.getObjectCoreReferenceAt(i)->barName != state.barDataList.GetAt(i).barName)
-                || (this->barDataList.getObjectCoreReferenceAt(i)->barValue != state.barDataList.GetAt(i).barValue))
+            if((this->barDataList.GetAt(i).barName != state.barDataList.GetAt(i).barName)
+                || (this->barDataList.GetAt(i).barValue != state.barDataList.GetAt(i).barValue))
             {
                 return false;
             }
@@ -934,7 +1037,7 @@ bool BarGraphState::operator==(const BarGraphState& state){
     return false;
 }
 
-bool BarGraphState::operator!=(const BarGraphState& state){
+bool BarGraphState::operator!=(const BarGraphState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -1039,7 +1142,7 @@ LineGraphState& LineGraphState::operator=(const LineGraphState& state){
     return *this;
 }
 
-bool LineGraphState::operator==(const LineGraphState& state){
+bool LineGraphState::operator==(const LineGraphState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->drawGridLines == state.drawGridLines)
         &&(this->drawAxisValues == state.drawAxisValues)&&(this->xIntersection == state.xIntersection)
         &&(this->xMaxValue == state.xMaxValue)&&(this->xMinValue == state.xMinValue)&&(this->yIntersection == state.yIntersection)
@@ -1052,7 +1155,7 @@ bool LineGraphState::operator==(const LineGraphState& state){
     }
 }
 
-bool LineGraphState::operator!=(const LineGraphState& state){
+bool LineGraphState::operator!=(const LineGraphState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -1142,7 +1245,7 @@ StringInterrogatorState& StringInterrogatorState::operator=(const StringInterrog
     return *this;
 }
 
-bool StringInterrogatorState::operator==(const StringInterrogatorState& state){
+bool StringInterrogatorState::operator==(const StringInterrogatorState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->buttonText == state.buttonText)
         &&(this->fieldOneContent == state.fieldOneContent)&&(this->fieldOneDescriptor == state.fieldOneDescriptor)
         &&(this->fieldOneHint == state.fieldOneHint)&&(this->fieldOneInputType == state.fieldOneInputType)
@@ -1158,7 +1261,7 @@ bool StringInterrogatorState::operator==(const StringInterrogatorState& state){
     }
 }
 
-bool StringInterrogatorState::operator!=(const StringInterrogatorState& state){
+bool StringInterrogatorState::operator!=(const StringInterrogatorState& state) const {
     return (*this == state) ? false : true;
 }
 
@@ -1374,7 +1477,7 @@ TextListPresenterState& TextListPresenterState::operator=(const TextListPresente
     return *this;
 }
 
-bool TextListPresenterState::operator==(const TextListPresenterState& state){
+bool TextListPresenterState::operator==(const TextListPresenterState& state) const {
     if((this->associatedPropertyID == state.associatedPropertyID)&&(this->useBackgroundStack == state.useBackgroundStack)){
         return true;
     }
@@ -1383,7 +1486,7 @@ bool TextListPresenterState::operator==(const TextListPresenterState& state){
     }
 }
 
-bool TextListPresenterState::operator!=(const TextListPresenterState& state){
+bool TextListPresenterState::operator!=(const TextListPresenterState& state) const {
     return (*this == state) ? false : true;
 }
 
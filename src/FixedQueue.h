@@ -0,0 +1,76 @@
+#ifndef FIXED_QUEUE_H
+#define FIXED_QUEUE_H
+
+/**
+ * @brief First-in-first-out ring buffer with a fixed capacity, no memory is allocated.
+ * NOTE: The queue is not synchronized, if it is shared between threads, the owner must lock the access.
+ *
+ * @tparam T The element type (copied on push and pop)
+ * @tparam N The capacity
+ */
+template<typename T, unsigned int N>
+class FixedQueue {
+public:
+    /**
+     * @brief Append an element
+     *
+     * @return true if the element was added, false if the queue is full
+     */
+    bool push(const T& element){
+        if(this->count >= N){
+            return false;
+        }
+        this->elements[(this->head + this->count) % N] = element;
+        this->count++;
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest element out of the queue
+     *
+     * @return true if an element was available
+     */
+    bool pop(T& element){
+        if(this->count == 0){
+            return false;
+        }
+        element = this->elements[this->head];
+        this->head = (this->head + 1) % N;
+        this->count--;
+        return true;
+    }
+
+    /**
+     * @brief Get a queued element without removing it
+     *
+     * @param index The position, 0 is the oldest element
+     * @return T* - nullptr if the index is out of range
+     */
+    T* peekAt(unsigned int index){
+        return (index < this->count) ? &this->elements[(this->head + index) % N] : nullptr;
+    }
+
+    unsigned int getCount() const {
+        return this->count;
+    }
+
+    unsigned int getFreeCount() const {
+        return N - this->count;
+    }
+
+    bool isFull() const {
+        return (this->count >= N) ? true : false;
+    }
+
+    void reset(){
+        this->head = 0;
+        this->count = 0;
+    }
+
+private:
+    T elements[N];
+    unsigned int head = 0;
+    unsigned int count = 0;
+};
+
+#endif // FIXED_QUEUE_H
@@ -1,6 +1,9 @@
 #ifndef ITEM_COLLECTION_H
 #define ITEM_COLLECTION_H
 
+#include <utility>
+#include "memoryConfig.h"
+
 /*
     Protocol class for the element conformity of the itemCollection
 */
@@ -31,6 +34,14 @@ public:
         }
     }
 
+    itemCollection(itemCollection<T> &&col)
+        : itemCount(col.itemCount), _Items(col._Items)
+    {
+        // take over the elements
+        col.itemCount = 0;
+        col._Items = nullptr;
+    }
+
     ~itemCollection()
     {
         this->Clear();
@@ -55,84 +66,15 @@ public:
      */
     void AddItem(const T &item)
     {
-        if (this->itemCount == 0)
-        {
-            this->_Items = new T *;
-            if (this->_Items != nullptr)
-            {
-                *this->_Items = new T();
-                if (*this->_Items != nullptr)
-                {
-                    **this->_Items = item;
-                    this->itemCount++;
-                }
-            }
-        }
-        else if (this->itemCount == 1)
-        {
-            // save
-            T *firstItem = *_Items;
-
-            // delete old
-            delete this->_Items;
-
-            // create new
-            this->_Items = new T *[2];
-            if (this->_Items != nullptr)
-            {
-                // set first item
-                this->_Items[0] = firstItem;
-
-                // copy and set the new item
-                this->_Items[1] = new T();
-                if (this->_Items[1] != nullptr)
-                {
-                    *this->_Items[1] = item;
-
-                    // increase counter
-                    this->itemCount++;
-                }
-            }
-        }
-        else
-        {
-            // save temporary
-            T **holder = new T *[this->itemCount];
-            if (holder != nullptr)
-            {
-                for (unsigned int i = 0; i < this->itemCount; i++)
-                {
-                    holder[i] = this->_Items[i];
-                }
-
-                // delete old
-                delete[] this->_Items;
-
-                // generate new
-                this->_Items = new T *[(this->itemCount + ((unsigned int)1))];
-                if (this->_Items != nullptr)
-                {
-                    // backup to array
-                    for (unsigned int i = 0; i < this->itemCount; i++)
-                    {
-                        this->_Items[i] = holder[i];
-                    }
-
-                    // copy and set new item
-                    this->_Items[this->itemCount] = new T();
-
-                    if (this->_Items[this->itemCount] != nullptr)
-                    {
-                        *this->_Items[this->itemCount] = item;
+        this->insertElement(this->itemCount, new T(item));
+    }
 
-                        // increase counter
-                        this->itemCount++;
-                    }
-                }
-                // delete holder
-                delete[] holder;
-            }
-        }
+    /**
+     * @brief Add an element to the collection by moving its content
+     */
+    void AddItem(T &&item)
+    {
+        this->insertElement(this->itemCount, new T(std::move(item)));
     }
 
     /**
@@ -149,38 +91,20 @@ public:
      */
     void InsertAt(unsigned int index, const T &item)
     {
-        if ((index >= 0) && (index < this->itemCount))
+        if (index <= this->itemCount)
         {
-            int initialItemCount = this->itemCount;
-
-            // at first take the last item and add it as a new item
-
-            /*
-                NOTE: This is a security copy - here a reference of an item out of the collection is taken and used as the input parameter for the AddItem method.
-                Since this method clears the original data, the element is deleted before it can be added - look at the method AddItem for more info!
-            */
-            T tempItem = this->GetAt(itemCount - 1);
-
-            this->AddItem(
-                tempItem);
-
-            // if there were more than 1 initial item, realign all items after the requested insertion index (excluding the last one)
-            if (initialItemCount > 1)
-            {
-                for (int i = (initialItemCount - 1); i > ((int)index); i--)
-                {
-                    this->ReplaceAt(
-                        i,
-                        this->GetAt(i - 1));
-                }
-            }
-            // insert the item
-            this->ReplaceAt(index, item);
+            this->insertElement(index, new T(item));
         }
-        else if (index == this->itemCount)
+    }
+
+    /**
+     * @brief Insert an element in the collection at the specified index by moving its content
+     */
+    void InsertAt(unsigned int index, T &&item)
+    {
+        if (index <= this->itemCount)
         {
-            // if the insertion-index is on the end of the collection, we only have to add it on the end of the collection
-            this->AddItem(item);
+            this->insertElement(index, new T(std::move(item)));
         }
     }
 
@@ -189,14 +113,23 @@ public:
      */
     void ReplaceAt(unsigned int index, const T &item)
     {
-        if (index < this->itemCount && index >= 0)
+        if (index < this->itemCount)
         {
-            delete this->_Items[index];
-            this->_Items[index] = new T();
             *this->_Items[index] = item;
         }
     }
 
+    /**
+     * @brief Replace an element in the collection at the specified index by moving the content of the new element
+     */
+    void ReplaceAt(unsigned int index, T &&item)
+    {
+        if (index < this->itemCount)
+        {
+            *this->_Items[index] = std::move(item);
+        }
+    }
+
     /**
      * @brief Remove an element from the collection at the specified index
      */
@@ -204,72 +137,42 @@ public:
     {
         if (index < this->itemCount)
         {
+            delete this->_Items[index];
+
             if (this->itemCount == 1)
             {
-                // delete all
-                delete *this->_Items;
-                delete this->_Items;
-
                 // no items anymore
-                this->itemCount = 0;
-            }
-            else if (this->itemCount == 2)
-            {
-                // save remaining item
-                T *sItem = (index == 0) ? this->_Items[1] : this->_Items[0];
-
-                // delete old
-                delete this->_Items[index];
                 delete[] this->_Items;
-
-                // create new ptr and set remaining item
-                this->_Items = new T *;
-                if (this->_Items != nullptr)
-                {
-                    *this->_Items = sItem;
-
-                    // one item remains
-                    this->itemCount = 1;
-                }
-                else
-                {
-                    // if the allocation fails, mark the collection as empty
-                    this->itemCount = 0;
-                }
+                this->_Items = nullptr;
+                this->itemCount = 0;
             }
             else
             {
-                // save remaining items
-                unsigned int aCnt = 0;
-                T **holder = new T *[this->itemCount - ((unsigned int)1)];
-                if (holder != nullptr)
+                // the remaining element pointers are realigned, the elements itself are not touched
+                T **items = new T *[this->itemCount - 1];
+                if (items != nullptr)
                 {
+                    unsigned int aCnt = 0;
                     for (unsigned int i = 0; i < this->itemCount; i++)
                     {
                         if (i != index)
                         {
-                            holder[aCnt] = this->_Items[i];
+                            items[aCnt] = this->_Items[i];
                             aCnt++;
                         }
                     }
-
-                    // delete old
-                    delete this->_Items[index];
-                    delete this->_Items;
-
-                    // create new
-                    this->_Items = new T *[itemCount - ((unsigned int)1)];
-                    if (this->_Items != nullptr)
+                    delete[] this->_Items;
+                    this->_Items = items;
+                    this->itemCount--;
+                }
+                else
+                {
+                    // if the allocation fails, close the gap in the existing array
+                    for (unsigned int i = index; i < (this->itemCount - 1); i++)
                     {
-                        // set remaining items
-                        for (unsigned int i = 0; i < (this->itemCount - ((unsigned int)1)); i++)
-                        {
-                            this->_Items[i] = holder[i];
-                        }
-                        // decrease counter
-                        this->itemCount--;
+                        this->_Items[i] = this->_Items[i + 1];
                     }
-                    delete[] holder;
+                    this->itemCount--;
                 }
             }
         }
@@ -284,19 +187,258 @@ public:
             {
                 delete this->_Items[i];
             }
-            if (this->itemCount > 1)
+            delete[] this->_Items;
+            this->_Items = nullptr;
+            this->itemCount = 0;
+        }
+    }
+
+    itemCollection<T> &operator=(const itemCollection<T> &col)
+    {
+        if (this != &col)
+        {
+            this->Clear();
+
+            for (unsigned int i = 0; i < col.itemCount; i++)
             {
-                delete[] this->_Items;
+                this->AddItem(col.GetAt(i));
             }
-            else
+        }
+        return *this;
+    }
+
+    itemCollection<T> &operator=(itemCollection<T> &&col)
+    {
+        if (this != &col)
+        {
+            this->Clear();
+
+            // take over the elements
+            this->itemCount = col.itemCount;
+            this->_Items = col._Items;
+            col.itemCount = 0;
+            col._Items = nullptr;
+        }
+        return *this;
+    }
+
+    void operator+=(const T &item)
+    {
+        this->AddItem(item);
+    }
+
+    T operator[](unsigned int position) const
+    {
+        return this->GetAt(position);
+    }
+
+    /**
+     * @brief This method returns a pointer to the allocated memory of the collection item at the specified index.
+     *	This gives direct access to the core data.
+     *  !USE WITH CAUTION! If used in the wrong way this method will corrupt the collection! Do not delete the element!
+     */
+    T *getObjectCoreReferenceAt(unsigned int index)
+    {
+        if (index < this->itemCount)
+        {
+            return this->_Items[index];
+        }
+        else
+        {
+            return nullptr;
+        }
+    }
+
+    /**
+     * @brief Get the memory occupied by the collection and its elements (dynamic memory owned by the elements is not included)
+     */
+    unsigned int GetMemoryUsage() const
+    {
+        return sizeof(itemCollection<T>) + (this->itemCount * (sizeof(T) + sizeof(T *)));
+    }
+
+private:
+    unsigned int itemCount;
+    T **_Items;
+
+    // insert an allocated element at the given index - only the pointer array is reallocated, the elements are not copied
+    void insertElement(unsigned int index, T *element)
+    {
+        if (element == nullptr)
+        {
+            return;
+        }
+        T **items = new T *[this->itemCount + 1];
+        if (items == nullptr)
+        {
+            delete element;
+            return;
+        }
+        for (unsigned int i = 0; i < index; i++)
+        {
+            items[i] = this->_Items[i];
+        }
+        items[index] = element;
+        for (unsigned int i = index; i < this->itemCount; i++)
+        {
+            items[i + 1] = this->_Items[i];
+        }
+        delete[] this->_Items;
+        this->_Items = items;
+        this->itemCount++;
+    }
+};
+
+/**
+ * @brief A collection with a fixed capacity which provides the interface of the itemCollection. The elements are part of the collection object,
+ * so no memory is allocated at runtime. If the capacity is exhausted, additional elements are discarded.
+ */
+template <class T, unsigned int N>
+class fixedItemCollection
+{
+public:
+    fixedItemCollection()
+        : itemCount(0) {}
+
+    fixedItemCollection(const fixedItemCollection<T, N> &col)
+        : itemCount(0)
+    {
+        for (unsigned int i = 0; i < col.itemCount; i++)
+        {
+            this->AddItem(col.GetAt(i));
+        }
+    }
+
+    /*Get the amount of items in the collection*/
+    unsigned int GetCount() const
+    {
+        return itemCount;
+    }
+
+    /*Get the maximum amount of items in the collection*/
+    unsigned int GetCapacity() const
+    {
+        return N;
+    }
+
+    /**
+     * @brief Add an element to the collection
+     */
+    void AddItem(T *item)
+    {
+        this->AddItem(*item);
+    }
+
+    /**
+     * @brief Add an element to the collection. The element is discarded if the capacity is exhausted.
+     */
+    void AddItem(const T &item)
+    {
+        if (this->itemCount < N)
+        {
+            this->_Items[this->itemCount] = item;
+            this->itemCount++;
+        }
+    }
+
+    /**
+     * @brief Add an element to the collection by moving its content. The element is discarded if the capacity is exhausted.
+     */
+    void AddItem(T &&item)
+    {
+        if (this->itemCount < N)
+        {
+            this->_Items[this->itemCount] = std::move(item);
+            this->itemCount++;
+        }
+    }
+
+    /**
+     * @brief Watch out: if the collection contains no items the access via GetAt(...) is invalid
+     * -> call GetCount( ) first to check the size of content
+     */
+    T &GetAt(unsigned int index) const
+    {
+        return const_cast<T &>(this->_Items[index]);
+    }
+
+    /**
+     * @brief Insert an element in the collection at the specified index. The element is discarded if the capacity is exhausted.
+     */
+    void InsertAt(unsigned int index, const T &item)
+    {
+        if ((index <= this->itemCount) && (this->itemCount < N))
+        {
+            this->makeGap(index);
+            this->_Items[index] = item;
+            this->itemCount++;
+        }
+    }
+
+    /**
+     * @brief Insert an element in the collection at the specified index by moving its content. The element is discarded if the capacity is exhausted.
+     */
+    void InsertAt(unsigned int index, T &&item)
+    {
+        if ((index <= this->itemCount) && (this->itemCount < N))
+        {
+            this->makeGap(index);
+            this->_Items[index] = std::move(item);
+            this->itemCount++;
+        }
+    }
+
+    /**
+     * @brief Replace an element in the collection at the specified index
+     */
+    void ReplaceAt(unsigned int index, const T &item)
+    {
+        if (index < this->itemCount)
+        {
+            this->_Items[index] = item;
+        }
+    }
+
+    /**
+     * @brief Replace an element in the collection at the specified index by moving the content of the new element
+     */
+    void ReplaceAt(unsigned int index, T &&item)
+    {
+        if (index < this->itemCount)
+        {
+            this->_Items[index] = std::move(item);
+        }
+    }
+
+    /**
+     * @brief Remove an element from the collection at the specified index
+     */
+    void RemoveAt(unsigned int index)
+    {
+        if (index < this->itemCount)
+        {
+            for (unsigned int i = index; i < (this->itemCount - 1); i++)
             {
-                delete this->_Items;
+                this->_Items[i] = std::move(this->_Items[i + 1]);
             }
-            this->itemCount = 0;
+            this->itemCount--;
+
+            // reset the released slot to free the resources of the element
+            this->_Items[this->itemCount] = T();
         }
     }
 
-    itemCollection<T> &operator=(const itemCollection<T> &col)
+    /* Clear all elements in the collection*/
+    void Clear()
+    {
+        for (unsigned int i = 0; i < this->itemCount; i++)
+        {
+            this->_Items[i] = T();
+        }
+        this->itemCount = 0;
+    }
+
+    fixedItemCollection<T, N> &operator=(const fixedItemCollection<T, N> &col)
     {
         this->Clear();
 
@@ -318,15 +460,14 @@ public:
     }
 
     /**
-     * @brief This method returns a pointer to the allocated memory of the collection item at the specified index.
+     * @brief This method returns a pointer to the collection item at the specified index.
      *	This gives direct access to the core data.
-     *  !USE WITH CAUTION! If used in the wrong way this method will corrupt the collection! Do not delete the element!
      */
     T *getObjectCoreReferenceAt(unsigned int index)
     {
         if (index < this->itemCount)
         {
-            return this->_Items[index];
+            return &this->_Items[index];
         }
         else
         {
@@ -334,9 +475,26 @@ public:
         }
     }
 
+    /**
+     * @brief Get the memory occupied by the collection and its elements (dynamic memory owned by the elements is not included)
+     */
+    unsigned int GetMemoryUsage() const
+    {
+        return sizeof(fixedItemCollection<T, N>);
+    }
+
 private:
     unsigned int itemCount;
-    T **_Items;
+    T _Items[N];
+
+    // move all items from the index on one position up
+    void makeGap(unsigned int index)
+    {
+        for (unsigned int i = this->itemCount; i > index; i--)
+        {
+            this->_Items[i] = std::move(this->_Items[i - 1]);
+        }
+    }
 };
 
 #endif
\ No newline at end of file
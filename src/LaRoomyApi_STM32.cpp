@@ -1,53 +1,165 @@
 #include "LaRoomyApi_STM32.h"
 
+#ifdef LAROOMY_STATIC_ALLOCATION
+// static storage for the property, group and state collections
+static fixedItemCollection<DeviceProperty, LAROOMY_MAX_PROPERTIES> staticDeviceProperties;
+static fixedItemCollection<DevicePropertyGroup, LAROOMY_MAX_GROUPS> staticDevicePropertyGroups;
+static fixedItemCollection<RGBSelectorState, LAROOMY_MAX_COMPLEX_STATES> staticRgbStates;
+static fixedItemCollection<ExtendedLevelSelectorState, LAROOMY_MAX_COMPLEX_STATES> staticExtendedLevelStates;
+static fixedItemCollection<TimeSelectorState, LAROOMY_MAX_COMPLEX_STATES> staticTimeSelectorStates;
+static fixedItemCollection<TimeFrameSelectorState, LAROOMY_MAX_COMPLEX_STATES> staticTimeFrameSelectorStates;
+static fixedItemCollection<DateSelectorState, LAROOMY_MAX_COMPLEX_STATES> staticDateSelectorStates;
+static fixedItemCollection<UnlockControlState, LAROOMY_MAX_COMPLEX_STATES> staticUnlockControlStates;
+static fixedItemCollection<NavigatorState, LAROOMY_MAX_COMPLEX_STATES> staticNavigatorStates;
+static fixedItemCollection<BarGraphState, LAROOMY_MAX_COMPLEX_STATES> staticBarGraphStates;
+static fixedItemCollection<LineGraphState, LAROOMY_MAX_COMPLEX_STATES> staticLineGraphStates;
+static fixedItemCollection<StringInterrogatorState, LAROOMY_MAX_COMPLEX_STATES> staticStringInterrogatorStates;
+static fixedItemCollection<TextListPresenterState, LAROOMY_MAX_COMPLEX_STATES> staticTextListPresenterStates;
+
+LaRoomyAppImplementation::LaRoomyAppImplementation()
+    : deviceProperties(staticDeviceProperties),
+      devicePropertyGroups(staticDevicePropertyGroups),
+      rgbStates(staticRgbStates),
+      extendedLevelStates(staticExtendedLevelStates),
+      timeSelectorStates(staticTimeSelectorStates),
+      timeFrameSelectorStates(staticTimeFrameSelectorStates),
+      dateSelectorStates(staticDateSelectorStates),
+      unlockControlStates(staticUnlockControlStates),
+      navigatorStates(staticNavigatorStates),
+      barGraphStates(staticBarGraphStates),
+      lineGraphStates(staticLineGraphStates),
+      stringInterrogatorStates(staticStringInterrogatorStates),
+      textListPresenterStates(staticTextListPresenterStates)
+{
+    // the reception string is reserved once, so that the assignment of received transmissions does not allocate memory
+    this->rxData.reserve(LAROOMY_MAX_PAYLOAD_SIZE);
+    this->registerTasks();
+}
+#else
+LaRoomyAppImplementation::LaRoomyAppImplementation(){
+    // the reception string is reserved once, so that the assignment of received transmissions does not allocate memory
+    this->rxData.reserve(LAROOMY_MAX_PAYLOAD_SIZE);
+    this->registerTasks();
+}
+#endif
+
 LaRoomyAppImplementation::~LaRoomyAppImplementation(){
     laRoomyAppImplInstanceCreated = false;
+    this->stopProtocolThread();
+    if(this->stateSnapshotPending){
+        this->saveStateSnapshot();
+    }
     this->ble_terminate();
+#ifdef LAROOMY_STATIC_ALLOCATION
+    // the static collections outlive the instance, so release their content
+    this->clearAllPropertiesAndGroups();
+#endif
 }
 
 bool LaRoomyAppImplementation::laRoomyAppImplInstanceCreated = false;
 LaRoomyAppImplementation* LaRoomyAppImplementation::hInstance = nullptr;
+#ifdef LAROOMY_STATIC_ALLOCATION
+alignas(LaRoomyAppImplementation) uint8_t LaRoomyAppImplementation::instanceStorage[sizeof(LaRoomyAppImplementation)];
+#endif
 
 void LaRoomyAppImplementation::begin(){
     this->hasBegun = true;
 }
 
 void LaRoomyAppImplementation::run(){
-    this->ble_start();
+    if(this->is_monitor_enabled){
+        this->printMemoryReport();
+    }
+    this->ble_createObjects();
+    this->startBluetooth();
+    // the stack is initialized here, the remaining steps are executed by onLoop()
+    this->ble_processLifecycle();
 }
 
 void LaRoomyAppImplementation::end(){
+#ifdef LAROOMY_STATIC_ALLOCATION
+    // the instance lives in static storage, so only the destructor is invoked
+    this->~LaRoomyAppImplementation();
+#else
     delete this;
+#endif
+}
+
+unsigned long LaRoomyAppImplementation::onLoop(){
+    return this->scheduler.run();
 }
 
-void LaRoomyAppImplementation::onLoop(){
-    BLE.poll();
-    // *****************************
-    if(this->tmc.tComplete){
+void LaRoomyAppImplementation::setProtocolPollInterval(unsigned long interval){
+    this->protocolPollInterval = interval;
+    this->scheduler.setTaskInterval(this->protocolTask, interval);
+}
+
+void LaRoomyAppImplementation::registerTasks(){
+    this->protocolTask = this->scheduler.addTask(&LaRoomyAppImplementation::protocolTaskFunction, this, this->protocolPollInterval);
+    this->storageTask = this->scheduler.addTask(&LaRoomyAppImplementation::storageTaskFunction, this, LAROOMY_STORAGE_FLUSH_INTERVAL);
+    // the snapshot task is scheduled when a state changes (see onPropertyStateChanged())
+    this->snapshotTask = this->scheduler.addTask(&LaRoomyAppImplementation::snapshotTaskFunction, this, 0, SCHEDULER_NO_DEADLINE);
+}
+
+void LaRoomyAppImplementation::protocolTaskFunction(void* context){
+    auto pComp = reinterpret_cast<LaRoomyAppImplementation*>(context);
+    pComp->processTransmissions();
+
+    // without an interval the task is one-shot, so it is due again on the next call
+    if(pComp->protocolPollInterval == 0){
+        pComp->scheduler.scheduleTask(pComp->protocolTask, 0);
+    }
+}
+
+void LaRoomyAppImplementation::storageTaskFunction(void* context){
+    // commit pending flash writes (only if the storage is in use)
+    if(FStorage::isCreated()){
+        FlashStorageManager.onLoop();
+    }
+}
+
+void LaRoomyAppImplementation::snapshotTaskFunction(void* context){
+    auto pComp = reinterpret_cast<LaRoomyAppImplementation*>(context);
+    if(pComp->stateSnapshotPending){
+        pComp->saveStateSnapshot();
+    }
+}
+
+void LaRoomyAppImplementation::processTransmissions(){
+    // in thread mode the protocol thread polls the stack, only the queued events and transmissions are processed here
+    if(!this->protocolThreadRunning){
+        this->ble_processLifecycle();
+        if(this->ble_isActive()){
+            BLE.poll();
+        }
+    }
+    this->dispatchProtocolEvents();
+
+    while(this->receiveTransmission()){
         if(this->is_monitor_enabled){
             Serial.print("Data received:  ");
-            Serial.println(this->tmc.data);
+            Serial.println(this->rxData);
             Serial.print("\r\n");
         }
 
-        switch(tmc.data.charAt(0)){
+        switch(this->rxData.charAt(0)){
             case '1':// property request
-                this->onPropertyRequest(tmc.data);
+                this->onPropertyRequest(this->rxData);
                 break;
             case '2':// group request
-                this->onGroupRequest(tmc.data);
+                this->onGroupRequest(this->rxData);
                 break;
             case '3':// property state request
-                this->onPropertyStateRequest(tmc.data);
+                this->onPropertyStateRequest(this->rxData);
                 break;
             case '4':// property execution command
-                this->onPropertyExecutionCommand(tmc.data);
+                this->onPropertyExecutionCommand(this->rxData);
                 break;
             case '5':// notification / command
-                this->onNotificationTransmission(tmc.data);
+                this->onNotificationTransmission(this->rxData);
                 break;
             case '6':// binding transmission
-                this->onBindingTransmission(tmc.data);
+                this->onBindingTransmission(this->rxData);
                 break;
             case '7':
                 this->onInitRequest();
@@ -56,20 +168,88 @@ void LaRoomyAppImplementation::onLoop(){
                 // unhandled transmission data
                 if(this->is_monitor_enabled){
                     Serial.print("WARNING - unhandled transmission data: ");
-                    Serial.print(tmc.data);
+                    Serial.print(this->rxData);
                     Serial.print("\r\n");
                 }
                 break;
-        }        
-        this->tmc.reset();
+        }
     }
 }
 
+void LaRoomyAppImplementation::printMemoryReport(){
+    unsigned int stateMemory =
+        this->rgbStates.GetMemoryUsage()
+        + this->extendedLevelStates.GetMemoryUsage()
+        + this->timeSelectorStates.GetMemoryUsage()
+        + this->timeFrameSelectorStates.GetMemoryUsage()
+        + this->dateSelectorStates.GetMemoryUsage()
+        + this->unlockControlStates.GetMemoryUsage()
+        + this->navigatorStates.GetMemoryUsage()
+        + this->barGraphStates.GetMemoryUsage()
+        + this->lineGraphStates.GetMemoryUsage()
+        + this->stringInterrogatorStates.GetMemoryUsage()
+        + this->textListPresenterStates.GetMemoryUsage();
+
+#ifdef LAROOMY_STATIC_ALLOCATION
+    Serial.println("LaRoomy memory report (static allocation) in bytes:");
+#else
+    Serial.println("LaRoomy memory report (dynamic allocation) in bytes:");
+#endif
+    Serial.print("  Api instance:         ");
+    Serial.println((unsigned int)sizeof(LaRoomyAppImplementation));
+    Serial.print("  - Properties:         ");
+    Serial.println(this->deviceProperties.GetMemoryUsage());
+    Serial.print("  - Groups:             ");
+    Serial.println(this->devicePropertyGroups.GetMemoryUsage());
+    Serial.print("  - Complex states:     ");
+    Serial.println(stateMemory);
+    Serial.print("  - Reception queue:    ");
+    Serial.println((unsigned int)sizeof(TransmissionControl));
+    Serial.print("  - Transmission queue: ");
+    Serial.println((unsigned int)sizeof(this->txQueue));
+    Serial.print("  - Event queue:        ");
+    Serial.println((unsigned int)sizeof(this->propertyEventQueue));
+    Serial.print("  - String arena:       ");
+    Serial.print(this->stringArena.getUsedBytes());
+    Serial.print(" of ");
+    Serial.print(this->stringArena.getCapacity());
+    Serial.print(" used by ");
+    Serial.print(this->stringArena.getStoredCount());
+    Serial.print(" strings (heap equivalent: ");
+    Serial.print(this->stringArena.getHeapEquivalent());
+    Serial.print(", not fitting: ");
+    Serial.print(this->stringArena.getRejectedCount());
+    Serial.println(")");
+    Serial.print("  Flash storage:        ");
+#ifdef LAROOMY_STATIC_ALLOCATION
+    // the store and the block device are embedded in the instance
+    Serial.println((unsigned int)sizeof(FStorage));
+#else
+    Serial.println((unsigned int)(sizeof(FStorage) + sizeof(TDBStore) + sizeof(FlashIAPBlockDevice)));
+#endif
+    Serial.print("  Binding controller:   ");
+    Serial.println((unsigned int)sizeof(BindingController));
+    Serial.print("  Pin storage:          ");
+    Serial.println((unsigned int)sizeof(UnlockControlPinStorageController));
+    Serial.print("\r\n");
+}
+
 void LaRoomyAppImplementation::addDeviceProperty(const DeviceProperty& p){
     this->_addDeviceProperty(p, true);
 }
 
+void LaRoomyAppImplementation::addDeviceProperty(DeviceProperty&& p){
+    this->_addDeviceProperty(std::move(p), true);
+}
+
 void LaRoomyAppImplementation::_addDeviceProperty(const DeviceProperty& p, bool sendCommand){
+    // add a copy, the content of the copy is moved into the collection
+    this->_addDeviceProperty(DeviceProperty(p), sendCommand);
+}
+
+void LaRoomyAppImplementation::_addDeviceProperty(DeviceProperty&& p, bool sendCommand){
+
+    this->onPropertyStructureChanged();
 
     if(this->is_monitor_enabled){
         if((p.propertyID == 0) || (p.propertyID == ID_DEVICE_MAIN_PAGE)){
@@ -88,8 +268,20 @@ void LaRoomyAppImplementation::_addDeviceProperty(const DeviceProperty& p, bool
             }
         }
     }
-    this->deviceProperties.AddItem(p);
-    this->initializeComplexPropertyState(p);
+    auto propertyID = p.propertyID;
+    auto count = this->deviceProperties.GetCount();
+
+    this->deviceProperties.AddItem(std::move(p));
+
+    if(this->deviceProperties.GetCount() == count){
+        // the property was not added (the capacity is exhausted)
+        if(this->is_monitor_enabled){
+            Serial.println("ERROR while adding property: The property capacity is exhausted.");
+        }
+        return;
+    }
+    this->bindPropertyDescriptorToArena(count);
+    this->initializeComplexPropertyState(propertyID);
 
     if(this->is_connected && sendCommand){
         // this is an add operation at runtime, so send an insert command (insert at the end)
@@ -105,6 +297,7 @@ void LaRoomyAppImplementation::_addDeviceProperty(const DeviceProperty& p, bool
 }
 
 void LaRoomyAppImplementation::addDevicePropertyGroup(const DevicePropertyGroup& g){
+    this->onPropertyStructureChanged();
     // verify the group ID (no double IDs!)
     for(unsigned int i = 0; i < this->devicePropertyGroups.GetCount(); i++){
         if(this->devicePropertyGroups.getObjectCoreReferenceAt(i)->groupID == g.groupID){
@@ -126,17 +319,19 @@ void LaRoomyAppImplementation::addDevicePropertyGroup(const DevicePropertyGroup&
             prop.groupIndex = nextGroupIndex;
             prop.relatedGroupID = g.groupID;
             prop.flags |= PROPERTY_ELEMENT_FLAG_IS_GROUP_MEMBER;
-            this->_addDeviceProperty(prop, false);
+            this->_addDeviceProperty(std::move(prop), false);
         }
-        // at the group itself
-        this->devicePropertyGroups.AddItem(g);
-        // clear the property collection in the group element (no longer needed, but keep the amount)
+        // add the group itself - the property collection is not copied (no longer needed, but keep the amount)
+        DevicePropertyGroup group;
+        group.descriptor = g.descriptor;
+        group.imageID = g.imageID;
+        group.groupID = g.groupID;
+        group.propertyCount = g.propertyList.GetCount();
+        this->devicePropertyGroups.AddItem(group);
+
         if(nextGroupIndex < this->devicePropertyGroups.GetCount()){
-            // update prop count
-            this->devicePropertyGroups.getObjectCoreReferenceAt(nextGroupIndex)->propertyCount =
-                this->devicePropertyGroups.getObjectCoreReferenceAt(nextGroupIndex)->propertyList.GetCount();
-            // delete properties
-            this->devicePropertyGroups.getObjectCoreReferenceAt(nextGroupIndex)->propertyList.Clear();
+            // move the descriptor to the arena
+            this->bindGroupDescriptorToArena(nextGroupIndex);
         }
 
         if(this->is_connected){
@@ -147,8 +342,95 @@ void LaRoomyAppImplementation::addDevicePropertyGroup(const DevicePropertyGroup&
     }
 }
 
+void LaRoomyAppImplementation::addPropertyTable(const PropertyTableEntry* properties, unsigned int count, const GroupTableEntry* groups, unsigned int groupCount){
+    bool groupAdded = false;
+
+    for(unsigned int i = 0; i < count; i++){
+        auto groupID = properties[i].groupID;
+
+        if(groupID == 0){
+            // no group member
+            this->_addDeviceProperty(this->propertyFromTableEntry(properties[i]), true);
+        }
+        else {
+            if(this->groupIndexFromGroupID(groupID) != INVALID_ELEMENT_INDEX){
+                // the group was added with a previous member, otherwise the ID exists already
+                if(!this->checkIfPropertyExist(properties[i].propertyID) && this->is_monitor_enabled){
+                    Serial.println("ERROR while adding property table: Group-ID already exists.");
+                }
+                continue;
+            }
+            // look for the group definition
+            const GroupTableEntry* groupEntry = nullptr;
+            for(unsigned int j = 0; j < groupCount; j++){
+                if(groups[j].groupID == groupID){
+                    groupEntry = &groups[j];
+                    break;
+                }
+            }
+            if(groupEntry == nullptr){
+                if(this->is_monitor_enabled){
+                    Serial.println("ERROR while adding property table: Group-ID not found in the group table.");
+                }
+                continue;
+            }
+            // add all members of the group
+            unsigned int nextGroupIndex = this->devicePropertyGroups.GetCount();
+            unsigned int memberCount = 0;
+
+            for(unsigned int j = i; j < count; j++){
+                if(properties[j].groupID == groupID){
+                    auto prop = this->propertyFromTableEntry(properties[j]);
+                    prop.groupIndex = nextGroupIndex;
+                    prop.relatedGroupID = groupID;
+                    prop.flags |= PROPERTY_ELEMENT_FLAG_IS_GROUP_MEMBER;
+                    this->_addDeviceProperty(std::move(prop), false);
+                    memberCount++;
+                }
+            }
+            // add the group, the descriptor refers to the table
+            DevicePropertyGroup group;
+            if(groupEntry->descriptor != nullptr){
+                group.descriptor = String();
+                group.descriptorRef = groupEntry->descriptor;
+            }
+            else {
+                group.descriptor = "";
+            }
+            group.imageID = groupEntry->imageID;
+            group.groupID = groupID;
+            group.propertyCount = memberCount;
+            this->devicePropertyGroups.AddItem(std::move(group));
+            groupAdded = true;
+        }
+    }
+    if(groupAdded && this->is_connected){
+        // inserting groups is not supported, so force the app to reload the properties
+        this->sendPropertyReloadCommand();
+    }
+}
+
+DeviceProperty LaRoomyAppImplementation::propertyFromTableEntry(const PropertyTableEntry& entry){
+    DeviceProperty p;
+    p.propertyType = entry.propertyType;
+    p.propertyID = entry.propertyID;
+    p.imageID = entry.imageID;
+    p.propertyState = entry.propertyState;
+    if(entry.descriptor != nullptr){
+        // the descriptor is not copied, the property refers to the string in the table
+        p.descriptor = String();
+        p.descriptorRef = entry.descriptor;
+    }
+    else {
+        p.descriptor = "";
+    }
+    return p;
+}
+
 void LaRoomyAppImplementation::insertProperty(cID insertAfter, const DeviceProperty& p){
 
+    this->onPropertyStructureChanged();
+
     // verify the propery ID (no double IDs!)
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == p.propertyID){
@@ -162,7 +444,8 @@ void LaRoomyAppImplementation::insertProperty(cID insertAfter, const DevicePrope
     if(insertAfter == INSERT_FIRST){
         // insert on the top of the list
         this->deviceProperties.InsertAt(0, p);
-        this->initializeComplexPropertyState(p);
+        this->bindPropertyDescriptorToArena(0);
+        this->initializeComplexPropertyState(p.propertyID);
 
         if(this->is_connected){
             // send insert command
@@ -185,6 +468,8 @@ void LaRoomyAppImplementation::insertProperty(cID insertAfter, const DevicePrope
             if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == insertAfter){
                 // insert
                 this->deviceProperties.InsertAt(i + 1, p);
+                this->bindPropertyDescriptorToArena(i + 1);
+                this->initializeComplexPropertyState(p.propertyID);
                 // send command when applicable
                 if(this->is_connected){
                     this->sendData(
@@ -206,6 +491,8 @@ void LaRoomyAppImplementation::insertProperty(cID insertAfter, const DevicePrope
 
 void LaRoomyAppImplementation::insertPropertyInGroup(cID insertAfter, cID groupID, const DeviceProperty& p){
 
+    this->onPropertyStructureChanged();
+
     // verify the propery ID (no double IDs!)
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == p.propertyID){
@@ -242,16 +529,17 @@ void LaRoomyAppImplementation::insertPropertyInGroup(cID insertAfter, cID groupI
                     pp.groupIndex = groupIndex;
                     pp.flags |= PROPERTY_ELEMENT_FLAG_IS_GROUP_MEMBER;
                     // insert the property
-                    this->deviceProperties.InsertAt(i, pp);
+                    this->deviceProperties.InsertAt(i, std::move(pp));
+                    this->bindPropertyDescriptorToArena(i);
                     // initialize the state
-                    this->initializeComplexPropertyState(pp);
+                    this->initializeComplexPropertyState(p.propertyID);
                     // if this happens at app-runtime, notify app
                     if(this->is_connected){
                         // send insert command
                         this->sendData(
                             this->deviceProperties.getObjectCoreReferenceAt(i)->toTransmissionString(
                                 TransmissionSubType::INSERT,
-                                this->propertyIndexFromPropertyID(pp.propertyID)
+                                this->propertyIndexFromPropertyID(p.propertyID)
                             )
                         );
                     }
@@ -267,16 +555,17 @@ void LaRoomyAppImplementation::insertPropertyInGroup(cID insertAfter, cID groupI
                     pp.groupIndex = groupIndex;
                     pp.flags |= PROPERTY_ELEMENT_FLAG_IS_GROUP_MEMBER;
                     // insert the property
-                    this->deviceProperties.InsertAt(i + 1, pp);
+                    this->deviceProperties.InsertAt(i + 1, std::move(pp));
+                    this->bindPropertyDescriptorToArena(i + 1);
                     // initialize the state
-                    this->initializeComplexPropertyState(pp);
+                    this->initializeComplexPropertyState(p.propertyID);
                     // if this happens at app-runtime, notify app
                     if(this->is_connected){
                         // send insert command
                         this->sendData(
                             this->deviceProperties.getObjectCoreReferenceAt(i + 1)->toTransmissionString(
                                 TransmissionSubType::INSERT,
-                                this->propertyIndexFromPropertyID(pp.propertyID)
+                                this->propertyIndexFromPropertyID(p.propertyID)
                             )
                         );
                     }
@@ -293,13 +582,16 @@ void LaRoomyAppImplementation::insertPropertyInGroup(cID insertAfter, cID groupI
                     pp.groupIndex = groupIndex;
                     pp.flags |= PROPERTY_ELEMENT_FLAG_IS_GROUP_MEMBER;
                     // insert after the element with the insert after ID
-                    this->deviceProperties.InsertAt(i + 1, pp);
+                    this->deviceProperties.InsertAt(i + 1, std::move(pp));
+                    this->bindPropertyDescriptorToArena(i + 1);
+                    // initialize the state
+                    this->initializeComplexPropertyState(p.propertyID);
                     // send command when applicable
                     if(this->is_connected){
                         this->sendData(
                             this->deviceProperties.getObjectCoreReferenceAt(i + 1)->toTransmissionString(
                                 TransmissionSubType::INSERT,
-                                this->propertyIndexFromPropertyID(pp.propertyID)
+                                this->propertyIndexFromPropertyID(p.propertyID)
                             )
                         );
                     }
@@ -345,6 +637,10 @@ void LaRoomyAppImplementation::enableInternalBindingHandler(bool enable){
     }
 }
 
+void LaRoomyAppImplementation::enableInternalUnlockControlPinHandler(bool enable){
+    this->auto_handle_unlock_pin = enable;
+}
+
 unsigned int LaRoomyAppImplementation::getSimplePropertyState(cID pID){
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == pID){
@@ -354,115 +650,155 @@ unsigned int LaRoomyAppImplementation::getSimplePropertyState(cID pID){
     return INVALID_PROPERTY_STATE;
 }
 
-RGBSelectorState LaRoomyAppImplementation::getRGBSelectorState(cID rgbSelectorID){
+const RGBSelectorState& LaRoomyAppImplementation::getRGBSelectorState(cID rgbSelectorID){
     for(unsigned int i = 0; i < this->rgbStates.GetCount(); i++){
         if(this->rgbStates.getObjectCoreReferenceAt(i)->associatedPropertyID == rgbSelectorID){
             return this->rgbStates.GetAt(i);
         }
     }
-    return RGBSelectorState();
+    // no state with this ID, return a default state
+    static const RGBSelectorState defaultState;
+    return defaultState;
 }
 
-ExtendedLevelSelectorState LaRoomyAppImplementation::getExtendedLevelSelectorState(cID exLevelSelectID){
+const ExtendedLevelSelectorState& LaRoomyAppImplementation::getExtendedLevelSelectorState(cID exLevelSelectID){
     for(unsigned int i = 0; i < this->extendedLevelStates.GetCount(); i++){
         if(this->extendedLevelStates.getObjectCoreReferenceAt(i)->associatedPropertyID == exLevelSelectID){
             return this->extendedLevelStates.GetAt(i);
         }
     }
-    return ExtendedLevelSelectorState();
+    // no state with this ID, return a default state
+    static const ExtendedLevelSelectorState defaultState;
+    return defaultState;
 }
 
-TimeSelectorState LaRoomyAppImplementation::getTimeSelectorState(cID timeSelectorID){
+const TimeSelectorState& LaRoomyAppImplementation::getTimeSelectorState(cID timeSelectorID){
     for(unsigned int i = 0; i < this->timeSelectorStates.GetCount(); i++){
         if(this->timeSelectorStates.getObjectCoreReferenceAt(i)->associatedPropertyID == timeSelectorID){
             return this->timeSelectorStates.GetAt(i);
         }
     }
-    return TimeSelectorState();
+    // no state with this ID, return a default state
+    static const TimeSelectorState defaultState;
+    return defaultState;
 }
 
-TimeFrameSelectorState LaRoomyAppImplementation::getTimeFrameSelectorState(cID timeFrameSelectorID){
+const TimeFrameSelectorState& LaRoomyAppImplementation::getTimeFrameSelectorState(cID timeFrameSelectorID){
     for(unsigned int i = 0; i < this->timeFrameSelectorStates.GetCount(); i++){
         if(this->timeFrameSelectorStates.getObjectCoreReferenceAt(i)->associatedPropertyID == timeFrameSelectorID){
             return this->timeFrameSelectorStates.GetAt(i);
         }
     }
-    return TimeFrameSelectorState();
+    // no state with this ID, return a default state
+    static const TimeFrameSelectorState defaultState;
+    return defaultState;
 }
 
-DateSelectorState LaRoomyAppImplementation::getDateSelectorState(cID dateSelectorID){
+const DateSelectorState& LaRoomyAppImplementation::getDateSelectorState(cID dateSelectorID){
     for(unsigned int i = 0; i < this->dateSelectorStates.GetCount(); i++){
         if(this->dateSelectorStates.getObjectCoreReferenceAt(i)->associatedPropertyID == dateSelectorID){
             return this->dateSelectorStates.GetAt(i);
         }
     }
-    return DateSelectorState();
+    // no state with this ID, return a default state
+    static const DateSelectorState defaultState;
+    return defaultState;
 }
 
-UnlockControlState LaRoomyAppImplementation::getUnlockControlState(cID unlockControlID){
+const UnlockControlState& LaRoomyAppImplementation::getUnlockControlState(cID unlockControlID){
     for(unsigned int i = 0; i < this->unlockControlStates.GetCount(); i++){
         if(this->unlockControlStates.getObjectCoreReferenceAt(i)->associatedPropertyID == unlockControlID){
             return this->unlockControlStates.GetAt(i);
         }
     }
-    return UnlockControlState();
+    // no state with this ID, return a default state
+    static const UnlockControlState defaultState;
+    return defaultState;
 }
 
-NavigatorState LaRoomyAppImplementation::getNavigatorState(cID navigatorID){
+const NavigatorState& LaRoomyAppImplementation::getNavigatorState(cID navigatorID){
     for(unsigned int i = 0; i < this->navigatorStates.GetCount(); i++){
         if(this->navigatorStates.getObjectCoreReferenceAt(i)->associatedPropertyID == navigatorID){
             return this->navigatorStates.GetAt(i);
         }
     }
-    return NavigatorState();
+    // no state with this ID, return a default state
+    static const NavigatorState defaultState;
+    return defaultState;
 }
 
-BarGraphState LaRoomyAppImplementation::getBarGraphState(cID barGraphID){
+const BarGraphState& LaRoomyAppImplementation::getBarGraphState(cID barGraphID){
     for(unsigned int i = 0; i < this->barGraphStates.GetCount(); i++){
         if(this->barGraphStates.getObjectCoreReferenceAt(i)->associatedPropertyID == barGraphID){
             return this->barGraphStates.GetAt(i);
         }
     }
-    return BarGraphState();
+    // no state with this ID, return a default state
+    static const BarGraphState defaultState;
+    return defaultState;
 }
 
-LineGraphState LaRoomyAppImplementation::getLineGraphState(cID lineGraphID){
+const LineGraphState& LaRoomyAppImplementation::getLineGraphState(cID lineGraphID){
     for(unsigned int i = 0; i < this->lineGraphStates.GetCount(); i++){
         if(this->lineGraphStates.getObjectCoreReferenceAt(i)->associatedPropertyID == lineGraphID){
             return this->lineGraphStates.GetAt(i);
         }
     }
-    return LineGraphState();
+    // no state with this ID, return a default state
+    static const LineGraphState defaultState;
+    return defaultState;
 }
 
-StringInterrogatorState LaRoomyAppImplementation::getStringInterrogatorState(cID stringInterrogatorID){
+const StringInterrogatorState& LaRoomyAppImplementation::getStringInterrogatorState(cID stringInterrogatorID){
     for(unsigned int i = 0; i < this->stringInterrogatorStates.GetCount(); i++){
         if(this->stringInterrogatorStates.getObjectCoreReferenceAt(i)->associatedPropertyID == stringInterrogatorID){
-            this->stringInterrogatorStates.GetAt(i);
+            return this->stringInterrogatorStates.GetAt(i);
         }
     }
-    return StringInterrogatorState();
+    // no state with this ID, return a default state
+    static const StringInterrogatorState defaultState;
+    return defaultState;
 }
 
-TextListPresenterState LaRoomyAppImplementation::getTextListPresenterState(cID textListPresenterID){
+const TextListPresenterState& LaRoomyAppImplementation::getTextListPresenterState(cID textListPresenterID){
     for(unsigned int i = 0; i < this->textListPresenterStates.GetCount(); i++){
         if(this->textListPresenterStates.getObjectCoreReferenceAt(i)->associatedPropertyID == textListPresenterID){
             return this->textListPresenterStates.GetAt(i);
         }
     }
-    return TextListPresenterState();
+    // no state with this ID, return a default state
+    static const TextListPresenterState defaultState;
+    return defaultState;
 }
 
 void LaRoomyAppImplementation::updateDeviceProperty(const DeviceProperty& p){
 
+    this->onPropertyStructureChanged();
+
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == p.propertyID){
             // first check if the old element is part of a group
             unsigned int gIndex =
                 (this->deviceProperties.getObjectCoreReferenceAt(i)->flags & PROPERTY_ELEMENT_FLAG_IS_GROUP_MEMBER)
                 ? this->deviceProperties.getObjectCoreReferenceAt(i)->groupIndex : INVALID_ELEMENT_INDEX;
+            // save the arena slot of the old descriptor, it is reused if the new descriptor fits in
+            const char* previousDescriptorRef = this->deviceProperties.getObjectCoreReferenceAt(i)->descriptorRef;
+            // save the handler, it is kept if the type is unchanged
+            auto previousHandler = this->deviceProperties.getObjectCoreReferenceAt(i)->handler;
+            auto previousHandlerContext = this->deviceProperties.getObjectCoreReferenceAt(i)->handlerContext;
+            auto previousType = this->deviceProperties.getObjectCoreReferenceAt(i)->propertyType;
             // replace property in collection
             this->deviceProperties.ReplaceAt(i, p);
+            if(p.propertyType == previousType){
+                this->deviceProperties.getObjectCoreReferenceAt(i)->handler = previousHandler;
+                this->deviceProperties.getObjectCoreReferenceAt(i)->handlerContext = previousHandlerContext;
+            }
+            this->bindPropertyDescriptorToArena(i, previousDescriptorRef);
+            // the simple state is part of the element
+            this->onPropertyStateChanged(p.propertyID);
+            // the complex state is not changed by an update, so the initial state data of the new element is not needed
+            this->deviceProperties.getObjectCoreReferenceAt(i)->initialStateDefinition = String();
+            this->deviceProperties.getObjectCoreReferenceAt(i)->clearStateHolder();
             // if the old element was group-member, the new must be as well
             if(gIndex != INVALID_ELEMENT_INDEX){
                 this->deviceProperties.getObjectCoreReferenceAt(i)->groupIndex = gIndex;
@@ -472,27 +808,67 @@ void LaRoomyAppImplementation::updateDeviceProperty(const DeviceProperty& p){
             if(this->is_connected){
                 // if the description callback is set, call it to get the descriptor
                 if(this->pDescriptionCallback != nullptr){
+                    this->deviceProperties.getObjectCoreReferenceAt(i)->materializeDescriptor();
                     this->pDescriptionCallback->onPropertyDescriptionRequired(p.propertyID, this->lastLangID, this->deviceProperties.getObjectCoreReferenceAt(i)->descriptor);
                 }                
                 auto updateTransmissionData =
                     this->deviceProperties.getObjectCoreReferenceAt(i)->toTransmissionString(TransmissionSubType::UPDATE, i);
-                this->sendData(updateTransmissionData);
+                if(this->sendData(updateTransmissionData)){
+                    this->markStateSynchronized(i);
+                }
             }
             break;
         }
     }
 }
 
+bool LaRoomyAppImplementation::registerPropertyHandler(cID propertyID, PropertyHandler handler, void* context, PropertyType type, PropertyType alternativeType){
+    for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
+        auto property = this->deviceProperties.getObjectCoreReferenceAt(i);
+
+        if(property->propertyID == propertyID){
+            // the handler is invoked with the signature of its type, so the type must match
+            if((property->propertyType != (unsigned int)type) && (property->propertyType != (unsigned int)alternativeType)){
+                if(this->is_monitor_enabled){
+                    Serial.print("ERROR: The handler type does not match the property type. Property ID: ");
+                    Serial.println(propertyID);
+                }
+                return false;
+            }
+            property->handler = handler;
+            property->handlerContext = context;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LaRoomyAppImplementation::removePropertyHandler(cID propertyID){
+    for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
+        auto property = this->deviceProperties.getObjectCoreReferenceAt(i);
+
+        if(property->propertyID == propertyID){
+            property->handler = nullptr;
+            property->handlerContext = nullptr;
+            break;
+        }
+    }
+}
+
 DeviceProperty LaRoomyAppImplementation::getProperty(unsigned int propertyID){
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == propertyID){
-            return this->deviceProperties.GetAt(i);
+            // the returned copy must not refer to the arena, since it may outlive the property set
+            DeviceProperty p = this->deviceProperties.GetAt(i);
+            p.materializeDescriptor();
+            return p;
         }
     }
     return DeviceProperty();
 }
 
 void LaRoomyAppImplementation::removeProperty(cID propertyID){
+    this->onPropertyStructureChanged();
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == propertyID){
             if(this->is_connected){
@@ -533,6 +909,7 @@ void LaRoomyAppImplementation::removeProperty(cID propertyID){
 }
 
 void LaRoomyAppImplementation::removePropertyGroup(cID groupID){
+    this->onPropertyStructureChanged();
     // get the group index for the ID
     auto groupIndex = this->groupIndexFromGroupID(groupID);
     // remove the properties inside the group
@@ -563,6 +940,7 @@ void LaRoomyAppImplementation::removePropertyGroup(cID groupID){
 }
 
 void LaRoomyAppImplementation::enableProperty(cID propertyID){
+    this->onPropertyStructureChanged();
     // search if the property exists
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == propertyID){
@@ -588,6 +966,7 @@ void LaRoomyAppImplementation::enableProperty(cID propertyID){
 }
 
 void LaRoomyAppImplementation::disableProperty(cID propertyID){
+    this->onPropertyStructureChanged();
     // search if the property exists
     for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
         if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == propertyID){
@@ -613,18 +992,26 @@ void LaRoomyAppImplementation::disableProperty(cID propertyID){
 }
 
 void LaRoomyAppImplementation::clearAllPropertiesAndGroups(){
+    this->onPropertyStructureChanged();
+    // write pending state changes before the states are released
+    if(this->stateSnapshotPending){
+        this->saveStateSnapshot();
+    }
     this->devicePropertyGroups.Clear();
     this->deviceProperties.Clear();
     this->rgbStates.Clear();
     this->extendedLevelStates.Clear();
     this->timeSelectorStates.Clear();
     this->timeFrameSelectorStates.Clear();
+    this->dateSelectorStates.Clear();
     this->navigatorStates.Clear();
     this->unlockControlStates.Clear();
     this->barGraphStates.Clear();
     this->lineGraphStates.Clear();
     this->stringInterrogatorStates.Clear();
     this->textListPresenterStates.Clear();
+    // all descriptor views are released with the properties and groups
+    this->stringArena.reset();
 }
 
 void LaRoomyAppImplementation::sendUserMessage(UserMessageType type, UserMessageHoldingPeriod period, const String& message){
@@ -811,7 +1198,11 @@ void LaRoomyAppImplementation::connectHandler(BLEDevice central){
     if(pComp != nullptr){
         pComp->is_connected = true;
 
-        if(pComp->pLrCallback != nullptr){
+        if(pComp->protocolThreadRunning){
+            // the callback is invoked on the application thread
+            pComp->postProtocolEvent({ ProtocolEventType::CONNECTION_STATE_CHANGED, 0, 1 });
+        }
+        else if(pComp->pLrCallback != nullptr){
             pComp->pLrCallback->onConnectionStateChanged(true);
         }
     }
@@ -820,9 +1211,25 @@ void LaRoomyAppImplementation::connectHandler(BLEDevice central){
 void LaRoomyAppImplementation::disconnectHandler(BLEDevice central){
     auto pComp = LaRoomyAppImplementation::GetInstance();
     if(pComp != nullptr){
+        pComp->queueMutex.lock();
         pComp->is_connected = false;
+        // the states sent from here on are not received, the app reports the reconnection or loads the properties again
+        pComp->propertyLoadingDone = false;
 
-        if(pComp->pLrCallback != nullptr){
+        if(pComp->protocolThreadRunning){
+            // discard the data of the closed connection
+            if(pComp->txQueue.getCount() > 0){
+                // the queued states are already marked as synchronized, so the resume must not rely on the sequence numbers
+                pComp->stateResumeValid = false;
+            }
+            pComp->txQueue.reset();
+        }
+        pComp->queueMutex.unlock();
+
+        if(pComp->protocolThreadRunning){
+            pComp->postProtocolEvent({ ProtocolEventType::CONNECTION_STATE_CHANGED, 0, 0 });
+        }
+        else if(pComp->pLrCallback != nullptr){
             pComp->pLrCallback->onConnectionStateChanged(false);
         }
     }
@@ -835,19 +1242,14 @@ void LaRoomyAppImplementation::characteristicWritten(BLEDevice central, BLEChara
         auto vLen = characteristic.valueLength();
 
         if(vLen > 0){
-            const char* data = (const char*)characteristic.value();
-
-            char* securedData = new char[characteristic.valueLength() + 1];
-            if(securedData != nullptr){
+            pComp->queueMutex.lock();
+            auto queued = pComp->tmc.push((const char*)characteristic.value(), (unsigned int)vLen);
+            pComp->queueMutex.unlock();
 
-                for(int i = 0; i < characteristic.valueLength(); i++){
-                    securedData[i] = data[i];
+            if(!queued){
+                if(pComp->is_monitor_enabled){
+                    Serial.println("WARNING - reception queue full, transmission discarded.");
                 }
-                securedData[characteristic.valueLength()] = '\0';
-
-                pComp->tmc.setData(securedData);
-
-                delete [] securedData;
             }
         }
     }
@@ -910,7 +1312,8 @@ void LaRoomyAppImplementation::onPropertyRequest(const String& data){
                     i++;
                 }
 
-                // get descriptor
+                // get descriptor (the callback receives the current descriptor as string)
+                prop->materializeDescriptor();
                 this->pDescriptionCallback->onPropertyDescriptionRequired(prop->propertyID, this->lastLangID, prop->descriptor);
             }
 
@@ -965,7 +1368,8 @@ void LaRoomyAppImplementation::onGroupRequest(const String& data){
                     i++;
                 }
 
-                // get descriptor
+                // get descriptor (the callback receives the current descriptor as string)
+                group->materializeDescriptor();
                 this->pDescriptionCallback->onGroupDescriptionRequired(group->groupID, this->lastLangID, group->descriptor);
             }
 
@@ -1015,7 +1419,9 @@ void LaRoomyAppImplementation::onPropertyStateRequest(const String& data){
             response += twoBuffer;
             response += "\r\0";
 
-            this->sendData(response);
+            if(this->sendData(response)){
+                this->markStateSynchronized(pIndex);
+            }
         }
         else {
             // complex property state request
@@ -1119,7 +1525,9 @@ void LaRoomyAppImplementation::onPropertyStateRequest(const String& data){
             }
             // send response
             if(response.length() > 0){
-                this->sendData(response);
+                if(this->sendData(response)){
+                    this->markStateSynchronized(pIndex);
+                }
             }
         }
     }
@@ -1135,20 +1543,18 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
 
         switch(propertyElement->propertyType){
             case PropertyType::BUTTON:
-                // invoke button callback event
-                if(this->pLrCallback != nullptr){
-                    this->pLrCallback->onButtonPressed(propertyElement->propertyID);
+                // invoke the property handler or the button callback event (or queue it)
+                if(!this->queuePropertyEvent(propertyElement, nullptr, 0)){
+                    this->deliverPropertyEvent(propertyElement, nullptr);
                 }
                 break;
             case PropertyType::SWITCH:
                 // save data to property object
                 this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyState = (data.charAt(9) == '1') ? 1 : 0;
-                // invoke switch callback event
-                if(this->pLrCallback != nullptr){
-                    this->pLrCallback->onSwitchStateChanged(
-                        propertyElement->propertyID,
-                        (data.charAt(9) == '1') ? true : false
-                    );
+                this->onPropertyStateChanged(propertyElement->propertyID, true);
+                // invoke the property handler or the switch callback event (or queue it)
+                if(!this->queuePropertyEvent(propertyElement, &propertyElement->propertyState, 1)){
+                    this->deliverPropertyEvent(propertyElement, &propertyElement->propertyState);
                 }
                 break;
             case PropertyType::LEVEL_SELECTOR:
@@ -1158,12 +1564,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                         data.charAt(8),
                         data.charAt(9)
                     );
-                // invoke level selector callback event
-                if(this->pLrCallback != nullptr){
-                    this->pLrCallback->onLevelSelectorValueChanged(
-                        propertyElement->propertyID,
-                        this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyState
-                    );
+                this->onPropertyStateChanged(propertyElement->propertyID, true);
+                // invoke the property handler or the level selector callback event (or queue it)
+                if(!this->queuePropertyEvent(propertyElement, &propertyElement->propertyState, 1)){
+                    this->deliverPropertyEvent(propertyElement, &propertyElement->propertyState);
                 }
                 break;
             case PropertyType::LEVEL_INDICATOR:
@@ -1179,12 +1583,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                         data.charAt(8),
                         data.charAt(9)
                     );
-                // invoke option selector callback event
-                if(this->pLrCallback != nullptr){
-                    this->pLrCallback->onOptionSelectorIndexChanged(
-                        propertyElement->propertyID,
-                        this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyState
-                    );
+                this->onPropertyStateChanged(propertyElement->propertyID, true);
+                // invoke the property handler or the option selector callback event (or queue it)
+                if(!this->queuePropertyEvent(propertyElement, &propertyElement->propertyState, 1)){
+                    this->deliverPropertyEvent(propertyElement, &propertyElement->propertyState);
                 }
                 break;
             case PropertyType::RGB_SELECTOR:
@@ -1195,9 +1597,14 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // update state in collection
                     this->_updateRGBState(s, false);
-                    // invoke rgb state callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onRGBSelectorStateChanged(s.associatedPropertyID, s);
+                    // apply the state to the bound zones
+                    if(this->pRgbZoneControl != nullptr){
+                        this->pRgbZoneControl->applyBoundStateChange(s.associatedPropertyID, s);
+                    }
+                    // invoke the property handler or the rgb state callback (or queue it)
+                    uint8_t binaryState[STATE_BINARY_MAX_SIZE];
+                    if(!this->queuePropertyEvent(propertyElement, binaryState, s.toBinary(binaryState))){
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1209,9 +1616,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // update state in collection (partial)
                     this->_updateExLevelStateFromExecutionCommand(s);
-                    // invoke callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onExtendedLevelSelectorStateChanged(s.associatedPropertyID, s);
+                    // invoke the property handler or the callback (or queue it)
+                    uint8_t binaryState[STATE_BINARY_MAX_SIZE];
+                    if(!this->queuePropertyEvent(propertyElement, binaryState, s.toBinary(binaryState), (uint8_t)s.trackingType)){
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1223,9 +1631,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // update state in collection
                     this->_updateTimeSelectorState(s, false);
-                    // invoke callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onTimeSelectorStateChanged(s.associatedPropertyID, s);
+                    // invoke the property handler or the callback (or queue it)
+                    uint8_t binaryState[STATE_BINARY_MAX_SIZE];
+                    if(!this->queuePropertyEvent(propertyElement, binaryState, s.toBinary(binaryState))){
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1237,9 +1646,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // update state in collection
                     this->_updateTimeFrameSelectorState(s, false);
-                    // invoke callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onTimeFrameSelectorStateChanged(s.associatedPropertyID, s);
+                    // invoke the property handler or the callback (or queue it)
+                    uint8_t binaryState[STATE_BINARY_MAX_SIZE];
+                    if(!this->queuePropertyEvent(propertyElement, binaryState, s.toBinary(binaryState))){
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1251,9 +1661,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // update state in collection
                     this->_updateDateSelectorState(s, false);
-                    // invoke callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onDateSelectorStateChanged(s.associatedPropertyID, s);
+                    // invoke the property handler or the callback (or queue it)
+                    uint8_t binaryState[STATE_BINARY_MAX_SIZE];
+                    if(!this->queuePropertyEvent(propertyElement, binaryState, s.toBinary(binaryState))){
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1270,10 +1681,8 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                         // update the state in the collection and send an UI-Update
                         this->_updateUnlockControlState(s, true);
 
-                        // invoke callback
-                        if(this->pLrCallback != nullptr){
-                            this->pLrCallback->onUnlockControlStateChanged(s.associatedPropertyID, s);
-                        }                        
+                        // invoke the handler or the callback
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1285,9 +1694,10 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // update state in collection
                     this->_updateNavigatorState(s, false);
-                    // invoke callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onNavigatorStateChanged(s.associatedPropertyID, s);
+                    // invoke the property handler or the callback (or queue it)
+                    uint8_t binaryState[2] = { (uint8_t)s.buttonType, (uint8_t)s.actionType };
+                    if(!this->queuePropertyEvent(propertyElement, binaryState, 2)){
+                        this->deliverPropertyEvent(propertyElement, &s);
                     }
                 }
                 break;
@@ -1304,10 +1714,8 @@ void LaRoomyAppImplementation::onPropertyExecutionCommand(const String& data){
                     s.fromExecutionString(data);
                     s.associatedPropertyID = this->deviceProperties.getObjectCoreReferenceAt(pIndex)->propertyID;
                     // do not update the state in collection, the transmission is a "one-shot"
-                    // invoke callback
-                    if(this->pLrCallback != nullptr){
-                        this->pLrCallback->onStringInterrogatorDataReceived(s.associatedPropertyID, s.fieldOneContent, s.fieldTwoContent);
-                    }
+                    // invoke the handler or the callback
+                    this->deliverPropertyEvent(propertyElement, &s);
                 }
                 break;
             case PropertyType::TEXT_LIST_PRESENTER:
@@ -1393,10 +1801,15 @@ void LaRoomyAppImplementation::onBindingTransmission(const String& data){
         }
         else if(data.charAt(8) == '2'){
             // binding auth request
-            if(this->auto_handle_binding){
+            if(!this->bindingThrottle.isAttemptAllowed()){
+                // requests within the back-off delay are rejected without evaluation
+                this->sendBindingResponse(BindingResponseType::BINDING_AUTHENTICATION_FAIL_THROTTLED);
+            }
+            else if(this->auto_handle_binding){
                 auto bindC = BindingController::GetInstance();
                 if(bindC != nullptr){
                     auto result = bindC->handleBindingTransmission(BindingTransmissionTypes::B_AUTH_REQUEST, passKey);
+                    this->onBindingAuthenticationResult(result);
                     this->sendBindingResponse(result);
                 }
             }
@@ -1404,6 +1817,7 @@ void LaRoomyAppImplementation::onBindingTransmission(const String& data){
                 if(this->pLrCallback != nullptr){
                     auto result =
                         this->pLrCallback->onBindingTransmissionReceived(BindingTransmissionTypes::B_AUTH_REQUEST, passKey);
+                    this->onBindingAuthenticationResult(result);
                     this->sendBindingResponse(result);
                 }
             }
@@ -1411,11 +1825,22 @@ void LaRoomyAppImplementation::onBindingTransmission(const String& data){
     }
 }
 
+void LaRoomyAppImplementation::onBindingAuthenticationResult(BindingResponseType result){
+    if(result == BindingResponseType::BINDING_AUTHENTICATION_SUCCESS){
+        this->bindingThrottle.onAttemptSucceeded();
+    }
+    else if(result == BindingResponseType::BINDING_AUTHENTICATION_FAIL_WRONG_KEY){
+        this->bindingThrottle.onAttemptFailed();
+    }
+}
+
 void LaRoomyAppImplementation::onNotificationTransmission(const String& data){
     if(data.length() >= 9){
         switch(data.charAt(8)){
             case '1':// property loading complete notification
                 this->propertyLoadingDone = true;
+                // the app has loaded the current properties, so the state resume is possible from now on
+                this->stateResumeValid = this->stateResumeEnabled;
                 
                 if(this->pLrCallback != nullptr){
                     if(data.length() >= 10){
@@ -1480,6 +1905,9 @@ void LaRoomyAppImplementation::onNotificationTransmission(const String& data){
                 }
                 break;
             case '7':// device reconnected notification
+                // the app keeps the loaded properties on a reconnection
+                this->propertyLoadingDone = true;
+
                 if(this->pLrCallback != nullptr){
                     if(data.length() >= 11){
                         auto propIndex = Convert::x2CharHexValueToU8BitValue(
@@ -1493,7 +1921,10 @@ void LaRoomyAppImplementation::onNotificationTransmission(const String& data){
                     }
                 }
                 if(this->auto_refresh_states){
-                    this->sendRefreshAllStatesCommand();
+                    // send only the states changed since the last synchronization if possible
+                    if(!this->resumeChangedStates()){
+                        this->sendRefreshAllStatesCommand();
+                    }
                 }
                 break;
             case '9':// date request response
@@ -1540,42 +1971,49 @@ void LaRoomyAppImplementation::updateSimplePropertyState(cID propertyID, unsigne
             
             // save the state internal
             this->deviceProperties.getObjectCoreReferenceAt(i)->propertyState = value;
+            this->onPropertyStateChanged(propertyID);
 
             // send update transmissions if conditions are fulfilled
             if(this->is_connected && this->propertyLoadingDone){
-                char twoStr[2];
-                char stateUpdate[12];
+                if(this->sendSimpleStateUpdate(i, value)){
+                    this->markStateSynchronized(i);
+                }
+            }
+            break;
+        }
+    }
+}
 
-                stateUpdate[0] = '3';
-                stateUpdate[1] = '4';
+bool LaRoomyAppImplementation::sendSimpleStateUpdate(unsigned int propertyIndex, unsigned int value){
+    char twoStr[2];
+    char stateUpdate[12];
 
-                // set property index
-                Convert::u8BitValueToHexTwoCharBuffer(i, twoStr);
-                stateUpdate[2] = twoStr[0];
-                stateUpdate[3] = twoStr[1];
+    stateUpdate[0] = '3';
+    stateUpdate[1] = '4';
 
-                // set data size (fixed in this transmission)
-                stateUpdate[4] = '0';
-                stateUpdate[5] = '3';
+    // set property index
+    Convert::u8BitValueToHexTwoCharBuffer(propertyIndex, twoStr);
+    stateUpdate[2] = twoStr[0];
+    stateUpdate[3] = twoStr[1];
 
-                // flags
-                stateUpdate[6] = '0';
-                stateUpdate[7] = '3'; // 3 byte payload
+    // set data size (fixed in this transmission)
+    stateUpdate[4] = '0';
+    stateUpdate[5] = '3';
 
-                // set state
-                Convert::u8BitValueToHexTwoCharBuffer(value, twoStr);
-                stateUpdate[8] = twoStr[0];
-                stateUpdate[9] = twoStr[1];
+    // flags
+    stateUpdate[6] = '0';
+    stateUpdate[7] = '3'; // 3 byte payload
 
-                // set delimiter and terminator
-                stateUpdate[10] = '\r';
-                stateUpdate[11] = '\0';
+    // set state
+    Convert::u8BitValueToHexTwoCharBuffer(value, twoStr);
+    stateUpdate[8] = twoStr[0];
+    stateUpdate[9] = twoStr[1];
 
-                this->sendData(stateUpdate);
-            }
-            break;
-        }
-    }
+    // set delimiter and terminator
+    stateUpdate[10] = '\r';
+    stateUpdate[11] = '\0';
+
+    return this->sendData(stateUpdate);
 }
 
 void LaRoomyAppImplementation::updateRGBState(cID rgbSelectorID, RGBSelectorState& state){
@@ -1625,6 +2063,50 @@ void LaRoomyAppImplementation::updateTextListPresenterState(cID textListPresente
     this->_updateTextListPresenterState(state, true);
 }
 
+StateModifier<RGBSelectorState> LaRoomyAppImplementation::modifyRGBState(cID rgbSelectorID){
+    return StateModifier<RGBSelectorState>(this, findStoredState(this->rgbStates, rgbSelectorID));
+}
+
+StateModifier<ExtendedLevelSelectorState> LaRoomyAppImplementation::modifyExLevelState(cID extendedLevelSelectorID){
+    return StateModifier<ExtendedLevelSelectorState>(this, findStoredState(this->extendedLevelStates, extendedLevelSelectorID));
+}
+
+StateModifier<TimeSelectorState> LaRoomyAppImplementation::modifyTimeSelectorState(cID timeSelectorID){
+    return StateModifier<TimeSelectorState>(this, findStoredState(this->timeSelectorStates, timeSelectorID));
+}
+
+StateModifier<TimeFrameSelectorState> LaRoomyAppImplementation::modifyTimeFrameSelectorState(cID timeFrameSelectorID){
+    return StateModifier<TimeFrameSelectorState>(this, findStoredState(this->timeFrameSelectorStates, timeFrameSelectorID));
+}
+
+StateModifier<DateSelectorState> LaRoomyAppImplementation::modifyDateSelectorState(cID dateSelectorID){
+    return StateModifier<DateSelectorState>(this, findStoredState(this->dateSelectorStates, dateSelectorID));
+}
+
+StateModifier<UnlockControlState> LaRoomyAppImplementation::modifyUnlockControlState(cID unlockControlID){
+    return StateModifier<UnlockControlState>(this, findStoredState(this->unlockControlStates, unlockControlID));
+}
+
+StateModifier<NavigatorState> LaRoomyAppImplementation::modifyNavigatorState(cID navigatorID){
+    return StateModifier<NavigatorState>(this, findStoredState(this->navigatorStates, navigatorID));
+}
+
+StateModifier<BarGraphState> LaRoomyAppImplementation::modifyBarGraphState(cID barGraphID){
+    return StateModifier<BarGraphState>(this, findStoredState(this->barGraphStates, barGraphID));
+}
+
+StateModifier<LineGraphState> LaRoomyAppImplementation::modifyLineGraphState(cID lineGraphID){
+    return StateModifier<LineGraphState>(this, findStoredState(this->lineGraphStates, lineGraphID));
+}
+
+StateModifier<StringInterrogatorState> LaRoomyAppImplementation::modifyStringInterrogatorState(cID stringInterrogatorID){
+    return StateModifier<StringInterrogatorState>(this, findStoredState(this->stringInterrogatorStates, stringInterrogatorID));
+}
+
+StateModifier<TextListPresenterState> LaRoomyAppImplementation::modifyTextListPresenterState(cID textListPresenterID){
+    return StateModifier<TextListPresenterState>(this, findStoredState(this->textListPresenterStates, textListPresenterID));
+}
+
 void LaRoomyAppImplementation::barGraphFastDataPipeSetSingleBarValue(cID barGraphID, unsigned int barIndex, float barValue){
 
     if(this->is_connected){ // only do the job if it's worth it
@@ -2015,11 +2497,11 @@ void LaRoomyAppImplementation::lineGraphFastDataPipeAddPoint(cID lineGraphID, LP
     }
 }
 
-void LaRoomyAppImplementation::sendData(const String& data){
+bool LaRoomyAppImplementation::sendData(const String& data){
 
     if(!this->is_connected || data.length() == 0){
         // not connected -> skip execution
-        return;
+        return false;
     }
     // check if the data must be sent in fragments
     if(data.length() > OUT_MTU_SIZE){
@@ -2076,6 +2558,10 @@ void LaRoomyAppImplementation::sendData(const String& data){
             }
         }
 
+        // a partially sent transmission would be corrupted on the app side, so all fragments must fit in the transmission queue
+        if(!this->reserveTransmissionSlots((payLoad.length() + OUT_FRAGMENT_PAYLOAD_SIZE - 1) / OUT_FRAGMENT_PAYLOAD_SIZE)){
+            return false;
+        }
         cFragment = header;
 
         for(unsigned int i = 0; i < payLoad.length(); i++){
@@ -2097,7 +2583,7 @@ void LaRoomyAppImplementation::sendData(const String& data){
                     }
                 }
 
-                this->pTxCharacteristic->writeValue(cFragment.c_str());
+                this->transmit(cFragment.c_str());
                 cFragment = header;
             }
         }
@@ -2113,8 +2599,9 @@ void LaRoomyAppImplementation::sendData(const String& data){
                 cFragment.setCharAt(7, '7');
             }
 
-            this->pTxCharacteristic->writeValue(cFragment.c_str());
+            this->transmit(cFragment.c_str());
         }
+        return true;
     }
     else {
         // monitor
@@ -2123,70 +2610,22 @@ void LaRoomyAppImplementation::sendData(const String& data){
             Serial.println(data.c_str());
         }
         // send data
-        this->pTxCharacteristic->writeValue(data.c_str());
+        return this->transmit(data.c_str());
     }
 }
 
-void LaRoomyAppImplementation::ble_start(){
-
-    this->applyDeviceImageIDToBluetoothName();
-
-    BLE.begin();
-    BLE.setLocalName(this->bluetoothName.c_str());
-    BLE.setDeviceName(this->bluetoothName.c_str());
-
-    this->pService = new BLEService(this->serviceUUID.c_str());
-    if(this->pService != nullptr){
-
-        BLE.setAdvertisedService(*this->pService);
-
-        this->pTxCharacteristic =
-            new BLECharacteristic(this->txCharacteristicUUID.c_str(), BLERead | BLEWrite | BLENotify, 255);
-        
-        this->pRxCharacteristic = 
-            new BLECharacteristic(this->rxCharacteristicUUID.c_str(), BLERead | BLEWrite | BLENotify, 255);
-
-        if(this->pTxCharacteristic != nullptr && this->pRxCharacteristic != nullptr){
-        
-            this->pRxCharacteristic->setEventHandler(BLEWritten, LaRoomyAppImplementation::characteristicWritten);
-
-            this->pService->addCharacteristic(*this->pTxCharacteristic);
-            this->pService->addCharacteristic(*this->pRxCharacteristic);
-
-            BLE.addService(*this->pService);
-
-            BLE.setEventHandler(BLEConnected, LaRoomyAppImplementation::connectHandler);
-            BLE.setEventHandler(BLEDisconnected, LaRoomyAppImplementation::disconnectHandler);
-
-            BLE.advertise();
-        }
+void LaRoomyAppImplementation::bindPropertyDescriptorToArena(unsigned int index, const char* previousRef){
+    auto prop = this->deviceProperties.getObjectCoreReferenceAt(index);
+    if(prop != nullptr){
+        // reuse the previous arena slot if possible, otherwise append the descriptor
+        this->stringArena.bind(prop->descriptor, prop->descriptorRef, previousRef);
     }
 }
 
-void LaRoomyAppImplementation::ble_restart(){
-    this->ble_terminate();
-    this->ble_start();
-}
-
-void LaRoomyAppImplementation::ble_terminate(){
-
-    BLE.stopAdvertise();
-    delay(100);
-
-    BLE.end();
-    delay(100);
-
-    if(this->pService != nullptr){
-        delete this->pService;
-        this->pService = nullptr;
-    }
-    if(this->pTxCharacteristic != nullptr){
-        delete this->pTxCharacteristic;
-        this->pTxCharacteristic = nullptr;
-    }
-    if(this->pRxCharacteristic != nullptr){
-        delete this->pRxCharacteristic;
-        this->pRxCharacteristic = nullptr;
+void LaRoomyAppImplementation::bindGroupDescriptorToArena(unsigned int index){
+    auto group = this->devicePropertyGroups.getObjectCoreReferenceAt(index);
+    if(group != nullptr){
+        this->stringArena.bind(group->descriptor, group->descriptorRef);
     }
 }
 
@@ -2231,26 +2670,30 @@ bool LaRoomyAppImplementation::validatePropertyID(cID pID){
     return false;
 }
 
-void LaRoomyAppImplementation::applyDeviceImageIDToBluetoothName(){
+String LaRoomyAppImplementation::getAdvertisedBluetoothName(){
+    // the name is built on each start, so the image ID is not appended twice on a restart
+    String name;
 
     if(this->bluetoothName.length() > 26){
-        String tempName;
         for(unsigned int i = 0; i < this->bluetoothName.length(); i++){
             if(i < 26){
-                tempName += this->bluetoothName.charAt(i);
+                name += this->bluetoothName.charAt(i);
             } else {
                 break;
             }
         }
-        this->bluetoothName = tempName;
+    }
+    else {
+        name = this->bluetoothName;
     }
     if(this->deviceImageID > 0 && this->deviceImageID < 256){
         char tb[3];
         tb[2] = '\0';
-        this->bluetoothName += '_';       
+        name += '_';
         Convert::u8BitValueToHexTwoCharBuffer(this->deviceImageID, tb);
-        this->bluetoothName += tb;
+        name += tb;
     }
+    return name;
 }
 
 void LaRoomyAppImplementation::rearrangeGroupIndexes(){
@@ -2273,9 +2716,17 @@ void LaRoomyAppImplementation::rearrangeGroupIndexes(){
     }
 }
 
-void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProperty& p){
+void LaRoomyAppImplementation::initializeComplexPropertyState(cID propertyID){
 
-    auto pIndex = this->propertyIndexFromPropertyID(p.propertyID);
+    // the state is initialized from the stored property, the initial state definition is released afterwards
+    auto pp = this->deviceProperties.getObjectCoreReferenceAt(
+        this->propertyIndexFromPropertyID(propertyID)
+    );
+    if(pp == nullptr){
+        // the property was not added (e.g. the capacity is exhausted)
+        return;
+    }
+    auto& p = *pp;
 
     // initialize complex property states if required
     if(p.propertyType > PropertyType::OPTION_SELECTOR){
@@ -2287,7 +2738,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set the state from the definition
                 this->initRGBStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the initial state defintion
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2300,7 +2751,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set the state from the definition
                 this->initExLevelStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2313,7 +2764,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from definition
                 this->initTimeSelectorStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2326,7 +2777,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from defintion string
                 this->initTimeFrameSelectorStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2339,7 +2790,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from definition string
                 this->initDateSelectorStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2352,7 +2803,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from definition string
                 this->initUnlockControlStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2365,7 +2816,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from definition string
                 this->initNavigatorStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2378,7 +2829,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from pointer
                 this->initBarGraphStateFromInitialStatePointer(p.propertyID, p.barGraphStateHolder);
                 // clear state holder
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->clearStateHolder();
+                p.clearStateHolder();
             }
             else {
                 // insert default state
@@ -2391,7 +2842,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from pointer
                 this->initLineGraphStateFromInitialStatePointer(p.propertyID, p.lineGraphStateHolder);
                 // clear state holder
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->clearStateHolder();
+                p.clearStateHolder();
             }
             else {
                 // init default state
@@ -2404,7 +2855,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from pointer
                 this->initStringInterrogatorStateFromInitialStatePointer(p.propertyID, p.stringInterrogatorStateHolder);
                 // clear state holder
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->clearStateHolder();
+                p.clearStateHolder();
             }
             else {
                 // init default state
@@ -2417,7 +2868,7 @@ void LaRoomyAppImplementation::initializeComplexPropertyState(const DeviceProper
                 // set state from definition string
                 this->initTextListPresenterStateFromInitialStateString(p.propertyID, p.initialStateDefinition);
                 // clear the definition
-                this->deviceProperties.getObjectCoreReferenceAt(pIndex)->initialStateDefinition = "";
+                p.initialStateDefinition = String();
             }
             else {
                 // insert default state
@@ -2529,7 +2980,8 @@ void LaRoomyAppImplementation::initDefaultBarGraphState(cID propertyID){
 
 void LaRoomyAppImplementation::initBarGraphStateFromInitialStatePointer(cID propertyID, BarGraphState* state){
     state->associatedPropertyID = propertyID;
-    this->barGraphStates.AddItem(state);
+    // the holder is released after the initialization, so the content can be moved
+    this->barGraphStates.AddItem(std::move(*state));
 }
 
 void LaRoomyAppImplementation::initDefaultLineGraphState(cID propertyID){
@@ -2540,7 +2992,8 @@ void LaRoomyAppImplementation::initDefaultLineGraphState(cID propertyID){
 
 void LaRoomyAppImplementation::initLineGraphStateFromInitialStatePointer(cID propertyID, LineGraphState* state){
     state->associatedPropertyID = propertyID;
-    this->lineGraphStates.AddItem(state);
+    // the holder is released after the initialization, so the content can be moved
+    this->lineGraphStates.AddItem(std::move(*state));
 }
 
 void LaRoomyAppImplementation::initDefaultStringInterrogatorState(cID propertyID){
@@ -2551,7 +3004,8 @@ void LaRoomyAppImplementation::initDefaultStringInterrogatorState(cID propertyID
 
 void LaRoomyAppImplementation::initStringInterrogatorStateFromInitialStatePointer(cID propertyID, StringInterrogatorState* state){
     state->associatedPropertyID = propertyID;
-    this->stringInterrogatorStates.AddItem(state);
+    // the holder is released after the initialization, so the content can be moved
+    this->stringInterrogatorStates.AddItem(std::move(*state));
 }
 
 void LaRoomyAppImplementation::initDefaultTextListPresenterState(cID propertyID){
@@ -2580,14 +3034,12 @@ void LaRoomyAppImplementation::_updateRGBState(RGBSelectorState& state, bool sen
     }
     // check if the state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2605,14 +3057,12 @@ void LaRoomyAppImplementation::_updateExLevelState(ExtendedLevelSelectorState& s
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2624,6 +3074,7 @@ void LaRoomyAppImplementation::_updateExLevelStateFromExecutionCommand(ExtendedL
             // only update the level and the on param (other values are not incluced in the execution command!)
             this->extendedLevelStates.getObjectCoreReferenceAt(i)->levelValue = s.levelValue;
             this->extendedLevelStates.getObjectCoreReferenceAt(i)->isOn = s.isOn;
+            this->onPropertyStateChanged(s.associatedPropertyID, true);
         }
     }
 }
@@ -2641,14 +3092,12 @@ void LaRoomyAppImplementation::_updateTimeSelectorState(TimeSelectorState& state
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2666,14 +3115,12 @@ void LaRoomyAppImplementation::_updateTimeFrameSelectorState(TimeFrameSelectorSt
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2691,14 +3138,12 @@ void LaRoomyAppImplementation::_updateDateSelectorState(DateSelectorState& state
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2716,14 +3161,12 @@ void LaRoomyAppImplementation::_updateUnlockControlState(UnlockControlState& sta
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2741,14 +3184,12 @@ void LaRoomyAppImplementation::_updateNavigatorState(NavigatorState& state, bool
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2766,14 +3207,12 @@ void LaRoomyAppImplementation::_updateBarGraphState(BarGraphState& state, bool s
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2791,14 +3230,12 @@ void LaRoomyAppImplementation::_updateLineGraphState(LineGraphState& state, bool
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2816,14 +3253,12 @@ void LaRoomyAppImplementation::_updateStringInterrogatorState(StringInterrogator
     }
     // check if state was found
     if(isValid){
-        // send update
-        if(this->is_connected && send){
-            this->sendData(
-                state.toStateString(
-                    this->propertyIndexFromPropertyID(state.associatedPropertyID),
-                    TransmissionSubType::UPDATE
-                )
-            );
+        if(send){
+            this->commitStateModification(state, true);
+        }
+        else {
+            // the state was changed by the app
+            this->onPropertyStateChanged(state.associatedPropertyID, true);
         }
     }
 }
@@ -2876,6 +3311,10 @@ void LaRoomyAppImplementation::sendBindingResponse(BindingResponseType t){
         case BindingResponseType::BINDING_FAIL_NOT_IMPLEMENTED:
             this->sendData("6200040032\r\0");
             break;
+        case BindingResponseType::BINDING_AUTHENTICATION_FAIL_THROTTLED:
+            // the app has no throttle response, the error response does not report the key as wrong
+            this->sendData("6200040004\r\0");
+            break;
         default:
             // unknown error
             this->sendData("6200040004\r\0");
@@ -2887,20 +3326,27 @@ bool LaRoomyAppImplementation::checkUnlockControlPin(UnlockControlState& state){
 
     // first validate the pID
     if(this->validatePropertyID(state.associatedPropertyID)){
-        // then get the current state
-        auto curState =
-            this->getUnlockControlState(state.associatedPropertyID);
+        // the received pin data (no copies are made for the verification)
+        const char* received = state.pin.c_str();
+        size_t receivedLength = state.pin.length();
 
         if(state.mode == UnlockControlModes::UNLOCK_MODE){
             if(state.unlocked == false){
                 // in the lock-transmission is no pin included, so to keep the old pin
                 // the current pin must be set to the state object which is stored to the collection
                 // otherwise the pin would be overridden with an empty string object
-                state.pin = curState.pin;
+                // (if the pin is handled internally, the state holds no pin)
+                if(!this->auto_handle_unlock_pin){
+                    state.pin = this->getUnlockControlState(state.associatedPropertyID).pin;
+                }
                 return true;
             }
             else {
-                if(state.pin == curState.pin){
+                if(this->verifyUnlockControlPin(state.associatedPropertyID, received, receivedLength)){
+                    if(this->auto_handle_unlock_pin){
+                        // the plain pin is not kept
+                        state.pin = String();
+                    }
                     return true;
                 }
                 else {
@@ -2924,29 +3370,41 @@ bool LaRoomyAppImplementation::checkUnlockControlPin(UnlockControlState& state){
             }
         }
         else if(state.mode == UnlockControlModes::PIN_CHANGE_MODE){
-            // the old and the new pin must be in this string, so separate it
-            String oldPin;
-            String newPin;
-            bool isOld = true;
-            unsigned int nextValidIndex = 0;
+            // the old and the new pin are in this string: <old pin>:<separator><new pin>
+            auto separator =
+                (const char*)memchr(received, ':', receivedLength);
 
-            for(unsigned int i = 0; i < state.pin.length(); i++){
-                if((state.pin.charAt(i) == ':')&&(isOld)){
-                    nextValidIndex = i + 2;
-                    isOld = false;
-                }
-                if(isOld){
-                    oldPin += state.pin.charAt(i);
+            size_t oldPinLength = (separator != nullptr) ? (size_t)(separator - received) : receivedLength;
+            const char* newPin = (separator != nullptr) ? (separator + 2) : (received + receivedLength);
+            if(newPin > (received + receivedLength)){
+                newPin = received + receivedLength;
+            }
+            size_t newPinLength = (received + receivedLength) - newPin;
+
+            bool changed = false;
+
+            if(this->verifyUnlockControlPin(state.associatedPropertyID, received, oldPinLength)){
+                // the old pin is valid, so set the new pin
+                if(this->auto_handle_unlock_pin){
+                    // save the new pin as hash
+                    if((newPinLength > 0) && (newPinLength <= UNLOCK_CONTROL_PIN_MAX_LENGTH)){
+                        char pinBuffer[UNLOCK_CONTROL_PIN_MAX_LENGTH + 1];
+                        memcpy(pinBuffer, newPin, newPinLength);
+                        pinBuffer[newPinLength] = '\0';
+
+                        changed = PinStorageController.savePin(state.associatedPropertyID, pinBuffer);
+                        memset(pinBuffer, 0, sizeof(pinBuffer));
+                    }
+                    state.pin = String();
                 }
                 else {
-                    if(i >= nextValidIndex){
-                        newPin += state.pin.charAt(i);
-                    }
+                    String pin;
+                    pin.concat(newPin, newPinLength);
+                    state.pin = std::move(pin);
+                    changed = true;
                 }
             }
-            if(oldPin == curState.pin){
-                // the old pin is valid, so set the new pin
-                state.pin = newPin;
+            if(changed){
                 return true;
             }
             else {
@@ -2972,6 +3430,31 @@ bool LaRoomyAppImplementation::checkUnlockControlPin(UnlockControlState& state){
     return false;
 }
 
+bool LaRoomyAppImplementation::verifyUnlockControlPin(cID unlockControlID, const char* pin, size_t length){
+    // attempts within the back-off delay are rejected without evaluation
+    if(!this->unlockControlThrottle.isAttemptAllowed()){
+        return false;
+    }
+
+    bool valid;
+    if(this->auto_handle_unlock_pin){
+        valid = PinStorageController.verifyPin(unlockControlID, pin, length);
+    }
+    else {
+        // compare with the pin of the state
+        const String& statePin = this->getUnlockControlState(unlockControlID).pin;
+        valid = UnlockControlPinStorageController::comparePins(pin, length, statePin.c_str(), statePin.length());
+    }
+
+    if(valid){
+        this->unlockControlThrottle.onAttemptSucceeded();
+    }
+    else {
+        this->unlockControlThrottle.onAttemptFailed();
+    }
+    return valid;
+}
+
 // *********************************************************************************************************
 
 DeviceProperty::DeviceProperty(Button &b){
@@ -3163,32 +3646,61 @@ void DeviceProperty::copy(const DeviceProperty& p){
     this->propertyState = p.propertyState;
     this->descriptor = "";
     this->descriptor = p.descriptor;
+    this->descriptorRef = p.descriptorRef;
     this->groupIndex = p.groupIndex;
     this->flags = p.flags;
     this->isEnabled = p.isEnabled;
     this->propertyID = p.propertyID;
     this->relatedGroupID = p.relatedGroupID;
+    this->initialStateDefinition = p.initialStateDefinition;
+    this->handler = p.handler;
+    this->handlerContext = p.handlerContext;
+    this->changeSequence = p.changeSequence;
+    this->syncedSequence = p.syncedSequence;
+
+    // the state holders of this object are replaced by the holders of the source
+    this->clearStateHolder();
 
     if(p.barGraphStateHolder != nullptr){
-        if(this->barGraphStateHolder != nullptr){
-            delete this->barGraphStateHolder;
-        }
         this->barGraphStateHolder = new BarGraphState(*p.barGraphStateHolder);
     }
     if(p.lineGraphStateHolder != nullptr){
-        if(this->lineGraphStateHolder != nullptr){
-            delete this->lineGraphStateHolder;
-        }
         this->lineGraphStateHolder = new LineGraphState(*p.lineGraphStateHolder);
     }
     if(p.stringInterrogatorStateHolder != nullptr){
-        if(this->stringInterrogatorStateHolder != nullptr){
-            delete this->stringInterrogatorStateHolder;
-        }
         this->stringInterrogatorStateHolder = new StringInterrogatorState(*p.stringInterrogatorStateHolder);
     }      
 }
 
+void DeviceProperty::move(DeviceProperty& p){
+    this->propertyType = p.propertyType;
+    this->imageID = p.imageID;
+    this->propertyState = p.propertyState;
+    this->descriptor = std::move(p.descriptor);
+    this->descriptorRef = p.descriptorRef;
+    this->groupIndex = p.groupIndex;
+    this->flags = p.flags;
+    this->isEnabled = p.isEnabled;
+    this->propertyID = p.propertyID;
+    this->relatedGroupID = p.relatedGroupID;
+    this->initialStateDefinition = std::move(p.initialStateDefinition);
+    this->handler = p.handler;
+    this->handlerContext = p.handlerContext;
+    this->changeSequence = p.changeSequence;
+    this->syncedSequence = p.syncedSequence;
+
+    // take over the state holders of the source
+    this->clearStateHolder();
+
+    this->barGraphStateHolder = p.barGraphStateHolder;
+    this->lineGraphStateHolder = p.lineGraphStateHolder;
+    this->stringInterrogatorStateHolder = p.stringInterrogatorStateHolder;
+    p.barGraphStateHolder = nullptr;
+    p.lineGraphStateHolder = nullptr;
+    p.stringInterrogatorStateHolder = nullptr;
+    p.descriptorRef = nullptr;
+}
+
 void DeviceProperty::clearStateHolder(){
     if(this->barGraphStateHolder != nullptr){
         delete this->barGraphStateHolder;
@@ -3258,7 +3770,7 @@ String DeviceProperty::toTransmissionString(TransmissionSubType t, unsigned int
         Convert::u8BitValueToHexTwoCharBuffer(this->propertyState, twoBuffer);
         payLoadData += twoBuffer;
         // descriptor
-        payLoadData += this->descriptor;
+        payLoadData += this->descriptorData();
     }
     // *******************************
 
@@ -3341,7 +3853,7 @@ String DevicePropertyGroup::toTransmissionString(TransmissionSubType t, unsigned
             Convert::u8BitValueToHexTwoCharBuffer(this->imageID, twoBuffer);
             payLoadData += twoBuffer;
             // descriptor
-            payLoadData += this->descriptor;
+            payLoadData += this->descriptorData();
         }
         // *******************************
 
@@ -39,14 +39,23 @@ typedef unsigned int cID;
 #define INVALID_ELEMENT_INDEX   257
 #define INVALID_PROPERTY_STATE  257
 #define ID_DEVICE_MAIN_PAGE     16211
+#define ID_NOT_BOUND            ((cID)(0xFFFFFFFF))
+
+// the maximum size of a single state in the persistent state snapshot
+#define STATE_BINARY_MAX_SIZE   6
 
 #ifndef OUT_MTU_SIZE
 #define OUT_MTU_SIZE    20
 #endif
 
+// the number of payload characters in a fragment of a transmission larger than the MTU (8 header characters, see sendData(...))
+#define OUT_FRAGMENT_PAYLOAD_SIZE   11
+
 class DeviceProperty;
 class DevicePropertyGroup;
 
+template<class S> class StateModifier;
+
 class Button;
 class Switch;
 class LevelSelector;
@@ -80,6 +89,8 @@ class TextListPresenterState;
 class BarData;
 class LineGraphDataPoints;
 
+class RGBZoneControl;
+
 /**
  * @brief Point - Single coordinate definition (x/y)
  * 
@@ -102,7 +113,7 @@ typedef struct _POINT {
         this->y = p.y;
         return *this;
     }
-    bool operator==(const _POINT& p){
+    bool operator==(const _POINT& p) const {
         if(this->x == p.x && this->y == p.y){
             return true;
         }
@@ -110,7 +121,7 @@ typedef struct _POINT {
             return false;
         }
     }
-    bool operator!=(const _POINT& p){
+    bool operator!=(const _POINT& p) const {
         return (*this == p) ? false : true;
     }
 }POINT, *LPPOINT;
@@ -155,14 +166,14 @@ typedef struct _COLOR {
         return *this;
     }
 
-    bool operator== (const _COLOR& c){
+    bool operator== (const _COLOR& c) const {
         if((c.redPart == this->redPart)&&(c.greenPart == this->greenPart)&&(c.bluePart == this->bluePart)){
             return true;
         }
         return false;
     }
 
-    bool operator!= (const _COLOR& c){
+    bool operator!= (const _COLOR& c) const {
         return !(*this == c);
     }
 
@@ -226,6 +237,32 @@ typedef struct _UIMODEDATA {
     unsigned int dummy;
 } UIMODEDATA, *PUIMODEDATA;
 
+/**
+ * @brief Entry of a constant property table (see LaRoomyAppImplementation::addPropertyTable(...)).
+ * Declare the table as const array with string literals as descriptor, so that it is placed in flash memory.
+ * The descriptor must have the format of the property type, e.g. "Descriptor;;ButtonText" for a button or "Descriptor;;Option1;;Option2" for an option selector.
+ * Complex properties start with the default state.
+ */
+typedef struct _PROPERTYTABLEENTRY {
+    unsigned int propertyType;
+    cID propertyID;
+    uint8_t imageID;
+    const char* descriptor;
+    // the ID of the group (see GroupTableEntry) or zero if the property is not part of a group
+    cID groupID;
+    // the initial state of simple properties
+    uint8_t propertyState;
+} PropertyTableEntry;
+
+/**
+ * @brief Entry of a constant group table (see LaRoomyAppImplementation::addPropertyTable(...)).
+ */
+typedef struct _GROUPTABLEENTRY {
+    cID groupID;
+    uint8_t imageID;
+    const char* descriptor;
+} GroupTableEntry;
+
 /**
  * @brief Callback handler for remote events (state changes & notifications)
  * 
@@ -262,6 +299,23 @@ public:
     virtual void onUIModeRequestResponse(PUIMODEDATA pData){}
 };
 
+/*
+    Handler of a single property (see LaRoomyAppImplementation::setPropertyHandler(...)). The context is the pointer passed on registration,
+    e.g. the object which controls the hardware of the property.
+*/
+typedef void (*PropertyHandler)();
+typedef void (*ButtonHandler)(cID buttonID, void* context);
+typedef void (*SwitchHandler)(cID switchID, bool newState, void* context);
+typedef void (*SelectorValueHandler)(cID selectorID, unsigned int newValue, void* context);     // level selector and option selector
+typedef void (*RGBSelectorHandler)(cID rgbSelectorID, const RGBSelectorState& state, void* context);
+typedef void (*ExtendedLevelSelectorHandler)(cID extendedLevelSelectorID, const ExtendedLevelSelectorState& state, void* context);
+typedef void (*TimeSelectorHandler)(cID timeSelectorID, const TimeSelectorState& state, void* context);
+typedef void (*TimeFrameSelectorHandler)(cID timeFrameSelectorID, const TimeFrameSelectorState& state, void* context);
+typedef void (*DateSelectorHandler)(cID dateSelectorID, const DateSelectorState& state, void* context);
+typedef void (*UnlockControlHandler)(cID unlockControlID, const UnlockControlState& state, void* context);
+typedef void (*NavigatorHandler)(cID navigatorID, const NavigatorState& state, void* context);
+typedef void (*StringInterrogatorHandler)(cID stringInterrogatorID, String& fieldOneContent, String& fieldTwoContent, void* context);
+
 /**
  * @brief Callback for supporting language depended property and group descriptions
  * 
@@ -273,27 +327,129 @@ public:
 };
 
 /**
- * @brief Data-class for bluetooth reception control
+ * @brief Data-class for bluetooth reception control. The received transmissions are buffered in a fixed-size queue
+ * (LAROOMY_RX_QUEUE_DEPTH entries of LAROOMY_MAX_PAYLOAD_SIZE) until they are processed in the onLoop() method.
  * 
  */
 class TransmissionControl {
 public:
-    String data;
-    bool tComplete = false;
-
-    void reset(){
-        data = "";
-        tComplete = false;
+    /**
+     * @brief Copy a received transmission into the queue. If the queue is full, the transmission is discarded.
+     * 
+     * @param data The received data
+     * @param length The length of the data (truncated to LAROOMY_MAX_PAYLOAD_SIZE)
+     * @return true if the data was queued
+     */
+    bool push(const char* data, unsigned int length){
+        if(length == 0 || this->count >= LAROOMY_RX_QUEUE_DEPTH){
+            return false;
+        }
+        if(length > LAROOMY_MAX_PAYLOAD_SIZE){
+            length = LAROOMY_MAX_PAYLOAD_SIZE;
+        }
+        unsigned int slot = (this->head + this->count) % LAROOMY_RX_QUEUE_DEPTH;
+        for(unsigned int i = 0; i < length; i++){
+            this->slots[slot][i] = data[i];
+        }
+        this->slots[slot][length] = '\0';
+        this->count++;
+        return true;
     }
 
-    void setData(const char* str){
-        this->data = str;
-        if(this->data.length() > 0){
-            this->tComplete = true;
+    /**
+     * @brief Take the oldest transmission out of the queue.
+     * 
+     * @param data The string to assign the transmission to. If its capacity is sufficient, no memory is allocated.
+     * @return true if a transmission was available
+     */
+    bool pop(String& data){
+        if(this->count == 0){
+            return false;
         }
+        data = this->slots[this->head];
+        this->head = (this->head + 1) % LAROOMY_RX_QUEUE_DEPTH;
+        this->count--;
+        return true;
     }
+
+    void reset(){
+        this->head = 0;
+        this->count = 0;
+    }
+
+private:
+    char slots[LAROOMY_RX_QUEUE_DEPTH][LAROOMY_MAX_PAYLOAD_SIZE + 1];
+    unsigned int head = 0;
+    unsigned int count = 0;
 };
 
+/**
+ * @brief Outgoing transmission buffered for the protocol thread (a complete transmission or one fragment of it)
+ * 
+ */
+typedef struct _TRANSMISSIONSLOT {
+    char data[OUT_MTU_SIZE + 1];
+} TRANSMISSIONSLOT;
+
+/**
+ * @brief Event raised by the protocol thread and handled on the application thread
+ * 
+ */
+enum class ProtocolEventType : uint8_t { CONNECTION_STATE_CHANGED };
+
+typedef struct _PROTOCOLEVENT {
+    ProtocolEventType type;
+    unsigned int id;
+    int value;
+} PROTOCOLEVENT;
+
+/**
+ * @brief Property execution buffered in the event queue mode, the state is held in compact form
+ * 
+ */
+typedef struct _PROPERTYEVENT {
+    cID propertyID;
+    PropertyHandler handler;                // the handler of the property at reception time
+    void* handlerContext;
+    uint8_t propertyType;                   // PropertyType
+    uint8_t trackingType;                   // ExLevelTrackingType (extended level selector only)
+    uint8_t size;
+    uint8_t data[STATE_BINARY_MAX_SIZE];    // simple states: the value, navigator: button and action type, complex states: see toBinary(...)
+} PROPERTYEVENT;
+
+/**
+ * @brief Timing of the transitions into a state of the bluetooth lifecycle
+ * 
+ */
+typedef struct _BLETRANSITIONTIMING {
+    unsigned long count;                // number of transitions into the state
+    unsigned long lastTransitionTime;   // microseconds spent in the stack calls of the last transition
+    unsigned long maxTransitionTime;    // microseconds
+    unsigned long lastDuration;         // milliseconds the state was held before it was left the last time
+} BLETRANSITIONTIMING;
+
+/**
+ * @brief Timing statistics of the bluetooth lifecycle (see LaRoomyAppImplementation::restartBluetooth())
+ * 
+ */
+typedef struct _BLELIFECYCLESTATISTICS {
+    BLETRANSITIONTIMING states[BLE_STATE_COUNT];    // indexed by BLELifecycleState
+    unsigned long restartCount;
+    unsigned long lastRestartDuration;  // milliseconds from the restart request until the device is advertising again
+    unsigned long maxRestartDuration;   // milliseconds
+    unsigned long startFailureCount;    // failed initializations of the stack (retried after LAROOMY_BLE_SETTLE_TIME)
+} BLELIFECYCLESTATISTICS;
+
+/**
+ * @brief Radio parameters of a bluetooth profile (see LaRoomyAppImplementation::setBluetoothProfile(...)), in the units of the stack
+ * 
+ */
+typedef struct _BLEPROFILEPARAMETERS {
+    uint16_t advertisingInterval;       // units of 0.625 ms (32 - 16384)
+    uint16_t minConnectionInterval;     // units of 1.25 ms (6 - 3200), 0 to use the default of the stack
+    uint16_t maxConnectionInterval;     // units of 1.25 ms (6 - 3200), 0 to use the default of the stack
+} BLEPROFILEPARAMETERS;
+
 /**
  * @brief Implementation of the LaRoomy App functionality
  * 
@@ -313,7 +469,11 @@ public:
             return hInstance;
         }
         else {
+#ifdef LAROOMY_STATIC_ALLOCATION
+            hInstance = new (instanceStorage) LaRoomyAppImplementation();
+#else
             hInstance = new LaRoomyAppImplementation();
+#endif
             if(hInstance != nullptr){
                 laRoomyAppImplInstanceCreated = true;
             }
@@ -328,10 +488,88 @@ public:
     void begin();    
 
     /**
-     * @brief Initialize the bluetooth functionality and start advertising 
+     * @brief Initialize the bluetooth functionality and start advertising. The start of the bluetooth stack is executed by onLoop()
+     * (or by the protocol thread), see restartBluetooth().
      */
     void run();
 
+    /**
+     * @brief Restart the bluetooth stack (e.g. to apply a new bluetooth name). The restart does not block, it is executed step by step
+     * by onLoop() (or by the protocol thread): advertising -> stopping -> stopped -> starting -> advertising. Between the steps the stack
+     * is given LAROOMY_BLE_SETTLE_TIME to settle. An open connection is closed. The service and characteristic objects are reused.
+     */
+    void restartBluetooth();
+
+    /**
+     * @brief Stop the bluetooth stack (asynchronously, like restartBluetooth()). An open connection is closed.
+     */
+    void stopBluetooth();
+
+    /**
+     * @brief Start the bluetooth stack after it was stopped with stopBluetooth() (asynchronously, like restartBluetooth())
+     */
+    void startBluetooth();
+
+    BLELifecycleState getBluetoothState(){
+        return this->bleState;
+    }
+
+    /**
+     * @brief Get the timing statistics of the bluetooth lifecycle
+     * 
+     * @param statistics The structure to fill
+     */
+    void getBluetoothLifecycleStatistics(BLELIFECYCLESTATISTICS& statistics);
+
+    // reset the timing statistics of the bluetooth lifecycle
+    void resetBluetoothLifecycleStatistics();
+
+    /**
+     * @brief Select the bluetooth profile, this disables the automatic selection (see enableAutomaticBluetoothProfile(...)).
+     * The advertising interval is applied immediately (advertising is restarted). The connection interval is requested by the stack
+     * when a connection is established, ArduinoBLE provides no function to update the parameters of an open connection, so a change
+     * during a connection takes effect with the next connection.
+     * 
+     * @param profile The profile, the default is BLE_PROFILE_BALANCED (the default parameters of the stack)
+     */
+    void setBluetoothProfile(BLEProfile profile);
+
+    /**
+     * @brief Enable the automatic selection of the bluetooth profile: BLE_PROFILE_LOW_LATENCY while a complex property page is opened
+     * in the app and BLE_PROFILE_POWER_SAVING while the app is idle on the device main page. The interval of an open connection cannot be
+     * changed, so the selection is a request for the next connection: the profile selected last remains after a disconnection (advertising
+     * interval and requested connection interval). Until the first connection the profile applied before remains (BLE_PROFILE_BALANCED by default).
+     * 
+     * @param enable True to enable the automatic selection (the default is false)
+     */
+    void enableAutomaticBluetoothProfile(bool enable);
+
+    /**
+     * @brief Change the radio parameters of a profile, the change is applied if the profile is active
+     * 
+     * @param profile The profile to change
+     * @param parameters The parameters
+     */
+    void setBluetoothProfileParameters(BLEProfile profile, const BLEPROFILEPARAMETERS& parameters);
+
+    // get the requested bluetooth profile (the connection interval of an open connection may still be the one of a previous profile)
+    BLEProfile getBluetoothProfile(){
+        return this->activeBleProfile;
+    }
+
+    /**
+     * @brief Get the radio parameters requested from the stack: the advertising interval (in effect while advertising) and the connection
+     * interval which is requested when the next connection is established (not the interval negotiated for an open connection)
+     * 
+     * @param parameters The structure to fill
+     */
+    void getBluetoothProfileParameters(BLEPROFILEPARAMETERS& parameters);
+
+    // get the number of profile changes passed to the stack
+    unsigned long getBluetoothProfileChangeCount(){
+        return this->bleProfileChangeCount;
+    }
+
     /**
      * @brief De-Initialize All - This method stops all bluetooth processes, deletes all property and property state data and resets
      * all control parameter
@@ -339,10 +577,152 @@ public:
     void end();    
 
     /**
-     * @brief Handle events - must be implemented in the main loop
+     * @brief Handle events - must be implemented in the main loop. Executes the due tasks of the library scheduler (the bluetooth polling,
+     * the processing of received transmissions, the storage flush and the state snapshot, plus the tasks added by the application and
+     * attached RGBControl objects).
      * 
+     * @return unsigned long - the time in milliseconds until the next task is due, the application can sleep or do other work in the meantime
      */
-    void onLoop();
+    unsigned long onLoop();
+
+    /**
+     * @brief Get the scheduler executed by onLoop(). Use it to add application tasks (e.g. sampling data for the fast-data-pipes)
+     * or to query the timing statistics (loop jitter).
+     * 
+     * @return TaskScheduler& 
+     */
+    TaskScheduler& getScheduler(){
+        return this->scheduler;
+    }
+
+    /**
+     * @brief Start the protocol thread. In this mode the bluetooth polling and all radio transmissions are executed on a dedicated RTOS thread,
+     * so the application thread never waits for radio I/O. Received transmissions and connection events are queued and handled in onLoop(),
+     * so the callbacks and the property states remain on the application thread. The outgoing data of the update calls is queued
+     * (LAROOMY_TX_QUEUE_DEPTH) and sent by the protocol thread.
+     * NOTE: Call after run(). onLoop() must still be called, but it only processes the queues.
+     * 
+     * @param priority The priority of the thread, should be lower than the priority of time-critical threads
+     * @param stackSize The stack size in bytes (ignored in static allocation mode, see LAROOMY_PROTOCOL_THREAD_STACK_SIZE)
+     * @return true if the thread was started
+     */
+    bool startProtocolThread(osPriority priority = osPriorityNormal, uint32_t stackSize = LAROOMY_PROTOCOL_THREAD_STACK_SIZE);
+
+    /**
+     * @brief Stop the protocol thread and return to polling in onLoop(). Called automatically by end().
+     * 
+     */
+    void stopProtocolThread();
+
+    bool isProtocolThreadRunning(){
+        return this->protocolThreadRunning;
+    }
+
+    /**
+     * @brief Get the number of outgoing transmissions discarded because the transmission queue of the protocol thread was full
+     * 
+     * @return unsigned int 
+     */
+    unsigned int getTxQueueOverflowCount(){
+        return this->txQueueOverflowCount;
+    }
+
+    /**
+     * @brief Enable the event queue mode. In this mode the property executions received from the app are not passed to the callback immediately,
+     * they are buffered (LAROOMY_PROPERTY_EVENT_QUEUE_DEPTH) and passed to the callback when the application calls dispatchPropertyEvents(...).
+     * So a slow callback (e.g. I2C communication) does not delay the processing of the bluetooth transmissions.
+     * The property states are updated immediately, only the callback is deferred. Consecutive events of the same property can be coalesced (see setEventCoalescing(...)).
+     * NOTE: Unlock control and string interrogator executions, the binding and all other callbacks are not queued.
+     * 
+     * @param enable True to enable the mode, on disabling the pending events are dispatched
+     */
+    void enableEventQueueMode(bool enable);
+
+    bool isEventQueueModeEnabled(){
+        return this->eventQueueMode;
+    }
+
+    /**
+     * @brief Pass the queued property events to the callback (in the order of reception). Call from the application thread, e.g. in the main loop.
+     * 
+     * @param maxEvents The maximum number of events to dispatch in this call, 0 dispatches all pending events
+     * @return unsigned int - the number of dispatched events
+     */
+    unsigned int dispatchPropertyEvents(unsigned int maxEvents = 0);
+
+    /**
+     * @brief Define if a queued event of a property type is replaced by a newer event of the same property (as long as no other event of the property
+     * was queued in between). For extended level selectors only the intermediate tracking values are coalesced, start and end of the tracking are preserved.
+     * The default is enabled for level selectors, extended level selectors and RGB selectors.
+     * 
+     * @param type The property type
+     * @param enable True to coalesce the events
+     */
+    void setEventCoalescing(PropertyType type, bool enable);
+
+    // the number of queued property events
+    unsigned int getPendingEventCount(){
+        return this->propertyEventQueue.getCount();
+    }
+
+    // the number of property events discarded because the queue was full
+    unsigned int getDroppedEventCount(){
+        return this->droppedEventCount;
+    }
+
+    // the number of property events replaced by a newer event
+    unsigned int getCoalescedEventCount(){
+        return this->coalescedEventCount;
+    }
+
+    void resetEventCounters(){
+        this->droppedEventCount = 0;
+        this->coalescedEventCount = 0;
+    }
+
+    /**
+     * @brief Set the interval for polling the bluetooth stack and processing the received transmissions.
+     * Default is LAROOMY_PROTOCOL_POLL_INTERVAL (0). A higher value reduces the wakeups but increases the response time.
+     * 
+     * @param interval The interval in milliseconds, 0 polls on every call of onLoop() (in protocol thread mode at least every millisecond)
+     */
+    void setProtocolPollInterval(unsigned long interval);
+
+    /**
+     * @brief Print the memory occupied by the library subsystems to the serial monitor. If the monitor is enabled, the report is
+     * printed automatically when run() is called. In static allocation mode the reported values are the reserved (maximum) sizes,
+     * otherwise they reflect the current content. Memory allocated by string objects is not included.
+     */
+    void printMemoryReport();
+
+    /**
+     * @brief Enable the persistence of the property states. Changed states are collected and written to the flash storage as one
+     * compact snapshot when the debounce time has elapsed since the first change, so a series of changes (e.g. a slider movement)
+     * results in one flash write. The snapshot is only written if its content has changed.
+     * Persisted are the states of switches, level-selectors, level-indicators, option-selectors and the complex states of
+     * rgb-selectors, extended-level-selectors (on/off and level), time-selectors, time-frame-selectors and date-selectors.
+     * NOTE: Call restorePropertyStates() after the properties are added and before run() to load the last snapshot.
+     * 
+     * @param enable True to enable the persistence
+     * @param debounceTime The time in milliseconds between the first change and the snapshot write
+     */
+    void enableStatePersistence(bool enable, unsigned long debounceTime = LAROOMY_STATE_SNAPSHOT_DEBOUNCE_TIME);
+
+    /**
+     * @brief Load the state snapshot from the flash storage (with one read) and apply it to the added properties.
+     * States of properties which do not exist anymore or which have changed their type are ignored. No transmissions are sent,
+     * so this should be called before run().
+     * 
+     * @return bool - true if a snapshot was found and applied
+     */
+    bool restorePropertyStates();
+
+    /**
+     * @brief Write pending state changes immediately (e.g. before the device is powered down) without waiting for the debounce time.
+     * 
+     * @return bool - false if the snapshot could not be written
+     */
+    bool saveStateSnapshot();
 
     /**
      * @brief Add a device property element
@@ -351,6 +731,13 @@ public:
      */
     void addDeviceProperty(const DeviceProperty& p);
 
+    /**
+     * @brief Add a device property element by moving its content into the property collection (no copy of the strings and initial states)
+     * 
+     * @param p The property element (it is empty after the call)
+     */
+    void addDeviceProperty(DeviceProperty&& p);
+
     /**
      * @brief Add a new group element. If the group element contains no deviceProperty objects, the element will be discarded
      * 
@@ -358,6 +745,34 @@ public:
      */
     void addDevicePropertyGroup(const DevicePropertyGroup& g);
 
+    /**
+     * @brief Add the properties and groups from constant tables. The descriptors are not copied, the property elements refer to the strings in the tables,
+     * so the tables and the strings must exist as long as the properties exist (declare them as global const arrays with string literals).
+     * The members of a group are added together at the position of the first member.
+     * 
+     * @param properties The property table
+     * @param count The number of entries in the property table
+     * @param groups The group table (can be nullptr if no property refers to a group)
+     * @param groupCount The number of entries in the group table
+     */
+    void addPropertyTable(const PropertyTableEntry* properties, unsigned int count, const GroupTableEntry* groups = nullptr, unsigned int groupCount = 0);
+
+    /**
+     * @brief Add the properties and groups from constant tables (see above)
+     */
+    template<unsigned int N, unsigned int G>
+    void addPropertyTable(const PropertyTableEntry (&properties)[N], const GroupTableEntry (&groups)[G]){
+        this->addPropertyTable(properties, N, groups, G);
+    }
+
+    /**
+     * @brief Add the properties from a constant table (see above)
+     */
+    template<unsigned int N>
+    void addPropertyTable(const PropertyTableEntry (&properties)[N]){
+        this->addPropertyTable(properties, N);
+    }
+
     /**
      * @brief Insert a new property element after the element with the given ID - if there is no element with the ID, the operation will be skipped
      * 
@@ -463,6 +878,70 @@ public:
         this->pLrCallback = callback;
     }
 
+    /**
+     * @brief Register a handler for the executions of a single property. The handler is stored in the property element and invoked instead of
+     * the callback interface method, so the application does not need to dispatch the property ID. Example:
+     *       LaRoomyApi.setPropertyHandler(PUMP_SWITCH_ID, [](cID id, bool on, void* ctx){ static_cast<Pump*>(ctx)->enable(on); }, &pump);
+     * NOTE: The property must be added before the handler is registered. The handler is kept if the property is updated with the same type,
+     * it is removed with the property.
+     * 
+     * @param propertyID The ID of the property
+     * @param handler The handler, the type must match the property type (SelectorValueHandler for level and option selectors)
+     * @param context The pointer passed to the handler
+     * @return true if the property exists and the handler type matches
+     */
+    bool setPropertyHandler(cID propertyID, ButtonHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::BUTTON);
+    }
+    bool setPropertyHandler(cID propertyID, SwitchHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::SWITCH);
+    }
+    bool setPropertyHandler(cID propertyID, SelectorValueHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(
+            propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::LEVEL_SELECTOR, PropertyType::OPTION_SELECTOR);
+    }
+    bool setPropertyHandler(cID propertyID, RGBSelectorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::RGB_SELECTOR);
+    }
+    bool setPropertyHandler(cID propertyID, ExtendedLevelSelectorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::EX_LEVEL_SELECTOR);
+    }
+    bool setPropertyHandler(cID propertyID, TimeSelectorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::TIME_SELECTOR);
+    }
+    bool setPropertyHandler(cID propertyID, TimeFrameSelectorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::TIME_FRAME_SELECTOR);
+    }
+    bool setPropertyHandler(cID propertyID, DateSelectorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::DATE_SELECTOR);
+    }
+    bool setPropertyHandler(cID propertyID, UnlockControlHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::UNLOCK_CONTROL);
+    }
+    bool setPropertyHandler(cID propertyID, NavigatorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::NAVIGATOR);
+    }
+    bool setPropertyHandler(cID propertyID, StringInterrogatorHandler handler, void* context = nullptr){
+        return this->registerPropertyHandler(propertyID, reinterpret_cast<PropertyHandler>(handler), context, PropertyType::STRING_INTERROGATOR);
+    }
+
+    /**
+     * @brief Remove the handler of a property, the executions are passed to the callback interface again
+     * 
+     * @param propertyID The ID of the property
+     */
+    void removePropertyHandler(cID propertyID);
+
+    /**
+     * @brief Register a RGBZoneControl object, the remote state changes of RGBSelectors bound to a zone are applied to the zone
+     * before the callback is invoked. Pass nullptr to remove the registration.
+     * 
+     * @param zoneControl The zone control object
+     */
+    void setRGBZoneControl(RGBZoneControl* zoneControl){
+        this->pRgbZoneControl = zoneControl;
+    }
+
     // subscribe this callback to support language dependend string resources
     void setDescriptionCallback(IElementDescriptionCallback* callback){
         this->pDescriptionCallback = callback;
@@ -524,6 +1003,8 @@ public:
     void setServiceUUID(const String& sUUID){
         this->serviceUUID = "";
         this->serviceUUID = sUUID;
+        // the objects are created again on the next start
+        this->bleObjectsOutdated = (this->pService != nullptr);
     }
 
     /**
@@ -531,6 +1012,7 @@ public:
     void setTxCharacteristicUUID(const String& cUUID){
         this->txCharacteristicUUID = "";
         this->txCharacteristicUUID = cUUID;
+        this->bleObjectsOutdated = (this->pService != nullptr);
     }
 
     /**
@@ -538,6 +1020,7 @@ public:
     void setRxCharacteristicUUID(const String& cUUID){
         this->rxCharacteristicUUID = "";
         this->rxCharacteristicUUID = cUUID;
+        this->bleObjectsOutdated = (this->pService != nullptr);
     }
 
     /**
@@ -571,6 +1054,23 @@ public:
         this->auto_refresh_states = enable;
     }
 
+    /**
+     * @brief Enable the state resume on reconnection. Each state change is numbered, and each property records the number of the last
+     * state which was transmitted to the app (or received from it) while the app was connected and had loaded the properties.
+     * If the app reports a restored connection, only the states with a newer change are sent as update transmissions instead
+     * of the 'refresh all states' command, which makes the app request every state.
+     * NOTE: If no property loading took place since the feature was enabled, or if the properties were added, removed or updated
+     * while the app was disconnected, the full refresh is used. The automatic state refresh must be enabled (see enableAutoRefreshStates(...)).
+     * 
+     * @param enable True to enable the state resume (the default is false)
+     */
+    void enableStateResume(bool enable);
+
+    // get the number of states sent by the last state resume
+    unsigned int getLastResumedStateCount(){
+        return this->lastResumedStateCount;
+    }
+
     /**
      * @brief If the internal binding handler is activated, all binding functions are handled internally.
      *  This means also that no callbacks are fired on binding events.
@@ -579,6 +1079,37 @@ public:
      */
     void enableInternalBindingHandler(bool enable);    
 
+    /**
+     * @brief If the internal unlock-control pin handler is activated, the pins of all unlock-control properties are verified and
+     *  changed with the PinStorageController: each unlock-control has its own pin which is stored as hash (see PinStorageController.savePin(id, pin)),
+     *  a new pin is saved internally. The pin member of the unlock-control state is not used in this mode (the state holds no pin).
+     *  If no pin was saved for an unlock-control, the default pin UNLOCK_CONTROL_DEFAULT_PIN is valid.
+     * 
+     * @param enable type: bool (enables or disables the handler)
+     */
+    void enableInternalUnlockControlPinHandler(bool enable);
+
+    /**
+     * @brief Get the throttle of the binding authentication. Failed authentication requests are delayed with an exponential back-off,
+     *  too many failed requests cause a lockout (see AttemptThrottle). Requests within the delay or the lockout are not evaluated, they are
+     *  answered with the error response (BINDING_AUTHENTICATION_FAIL_THROTTLED) instead of the wrong-key response.
+     * 
+     * @return AttemptThrottle& - use it to change the parameter or to query the state
+     */
+    AttemptThrottle& getBindingThrottle(){
+        return this->bindingThrottle;
+    }
+
+    /**
+     * @brief Get the throttle of the unlock-control pin verification (shared by all unlock-control properties). Unlock and pin-change
+     *  requests within the delay are rejected as wrong pin (see AttemptThrottle).
+     * 
+     * @return AttemptThrottle& - use it to change the parameter or to query the state
+     */
+    AttemptThrottle& getUnlockControlThrottle(){
+        return this->unlockControlThrottle;
+    }
+
     /**
      * @brief Get the current simple property state
      * 
@@ -591,89 +1122,89 @@ public:
      * @brief Get the RGB Selector State
      * 
      * @param rgbSelectorID The ID of the RGBSelector Property
-     * @return RGBSelectorState 
+     * @return const RGBSelectorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    RGBSelectorState getRGBSelectorState(cID rgbSelectorID);
+    const RGBSelectorState& getRGBSelectorState(cID rgbSelectorID);
 
     /**
      * @brief Get the Extended Level Selector State
      * 
      * @param exLevelSelectID The ID of the Extended Level Selector Property
-     * @return ExtendedLevelSelectorState 
+     * @return const ExtendedLevelSelectorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    ExtendedLevelSelectorState getExtendedLevelSelectorState(cID exLevelSelectID);
+    const ExtendedLevelSelectorState& getExtendedLevelSelectorState(cID exLevelSelectID);
 
     /**
      * @brief Get the Time Selector State
      * 
      * @param timeSelctorID The ID of the TimeSelector Property
-     * @return TimeSelectorState 
+     * @return const TimeSelectorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    TimeSelectorState getTimeSelectorState(cID timeSelectorID);
+    const TimeSelectorState& getTimeSelectorState(cID timeSelectorID);
 
     /**
      * @brief Get the Time Frame Selector State
      * 
      * @param timeFrameSelectorID The ID of the TimeFrameSelector Property
-     * @return TimeFrameSelectorState
+     * @return const TimeFrameSelectorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    TimeFrameSelectorState getTimeFrameSelectorState(cID timeFrameSelectorID);
+    const TimeFrameSelectorState& getTimeFrameSelectorState(cID timeFrameSelectorID);
 
     /**
      * @brief Get the Date Selector State
      * 
      * @param dateSelectorID The ID of the dateSelector Property
-     * @return DateSelectorState 
+     * @return const DateSelectorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    DateSelectorState getDateSelectorState(cID dateSelectorID);
+    const DateSelectorState& getDateSelectorState(cID dateSelectorID);
 
     /**
      * @brief Get the Unlock Control State
      * 
      * @param unlockControlID The ID of the UnlockControl Property
-     * @return UnlockControlState 
+     * @return const UnlockControlState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    UnlockControlState getUnlockControlState(cID unlockControlID);
+    const UnlockControlState& getUnlockControlState(cID unlockControlID);
 
     /**
      * @brief Get the Navigator State
      * 
      * @param navigatorID The ID of the Navigator Property
-     * @return NavigatorState 
+     * @return const NavigatorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    NavigatorState getNavigatorState(cID navigatorID);
+    const NavigatorState& getNavigatorState(cID navigatorID);
 
     /**
      * @brief Get the Bar Graph State
      * 
      * @param barGraphID The ID of the BarGraph Property
-     * @return BarGraphState 
+     * @return const BarGraphState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    BarGraphState getBarGraphState(cID barGraphID);
+    const BarGraphState& getBarGraphState(cID barGraphID);
 
     /**
      * @brief Get the Line Graph State
      * 
      * @param lineGraphID The ID of the LineGraph Property
-     * @return LineGraphState 
+     * @return const LineGraphState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    LineGraphState getLineGraphState(cID lineGraphID);
+    const LineGraphState& getLineGraphState(cID lineGraphID);
 
     /**
      * @brief Get the String Interrogator State
      * 
      * @param stringInterrogatorID The ID of the StringInterrogator Property
-     * @return StringInterrogatorState 
+     * @return const StringInterrogatorState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    StringInterrogatorState getStringInterrogatorState(cID stringInterrogatorID);
+    const StringInterrogatorState& getStringInterrogatorState(cID stringInterrogatorID);
 
     /**
      * @brief Get the Text List Presenter State
      * 
      * @param textListPresenterID The ID of the TextListPresenter Property
-     * @return TextListPresenterState 
+     * @return const TextListPresenterState& - do not hold the reference beyond the next property add, insert or remove operation
      */
-    TextListPresenterState getTextListPresenterState(cID textListPresenterID);
+    const TextListPresenterState& getTextListPresenterState(cID textListPresenterID);
 
     /**
      * @brief Update the state of simple-state property.
@@ -787,6 +1318,27 @@ public:
      */
     void updateTextListPresenterState(cID textListPresenterID, TextListPresenterState& state);
 
+    /**
+     * @brief Modify the stored states in place. The returned handle gives direct access to the stored state, when the handle goes out of scope
+     * a single complex-state-update transmission is sent (if the device is connected). Other than the update methods, no state copy is required.
+     * Example: { auto bg = LaRoomyApi.modifyBarGraphState(2); if(bg.isValid()){ bg->changeBarValueAt(0, 12.5); } }
+     * NOTE: Do not add, insert or remove properties while a handle exists. If the ID is not found the handle is invalid.
+     * 
+     * @param ID The ID of the property
+     * @return StateModifier - the handle to the stored state
+     */
+    StateModifier<RGBSelectorState> modifyRGBState(cID rgbSelectorID);
+    StateModifier<ExtendedLevelSelectorState> modifyExLevelState(cID extendedLevelSelectorID);
+    StateModifier<TimeSelectorState> modifyTimeSelectorState(cID timeSelectorID);
+    StateModifier<TimeFrameSelectorState> modifyTimeFrameSelectorState(cID timeFrameSelectorID);
+    StateModifier<DateSelectorState> modifyDateSelectorState(cID dateSelectorID);
+    StateModifier<UnlockControlState> modifyUnlockControlState(cID unlockControlID);
+    StateModifier<NavigatorState> modifyNavigatorState(cID navigatorID);
+    StateModifier<BarGraphState> modifyBarGraphState(cID barGraphID);
+    StateModifier<LineGraphState> modifyLineGraphState(cID lineGraphID);
+    StateModifier<StringInterrogatorState> modifyStringInterrogatorState(cID stringInterrogatorID);
+    StateModifier<TextListPresenterState> modifyTextListPresenterState(cID textListPresenterID);
+
     /**
      * @brief Sets the value of a bar in the specified barGraph property using the fast-data pipe bypass transmission.
      * This only makes sense if the specified barGraph property page is opened. Use the notification callback to detect when a
@@ -870,7 +1422,7 @@ public:
     void lineGraphFastDataPipeAddPoint(cID lineGraphID, LPPOINT pPoint);
 
 private:
-    LaRoomyAppImplementation(){}
+    LaRoomyAppImplementation();
 
     // bluetooth name with default value
     String bluetoothName = "My BLE Device";
@@ -883,35 +1435,128 @@ private:
     // instance params
     static bool laRoomyAppImplInstanceCreated;
     static LaRoomyAppImplementation* hInstance;
+#ifdef LAROOMY_STATIC_ALLOCATION
+    static uint8_t instanceStorage[];
+#endif
 
     // private properties
     bool hasBegun = false;
-    bool is_connected = false;
+    // written by the connection handlers (on the protocol thread in thread mode)
+    volatile bool is_connected = false;
     bool is_monitor_enabled = false;
     bool auto_refresh_states = true;
     bool auto_handle_binding = false;
+    bool auto_handle_unlock_pin = false;
+
+    // throttling of the authentication attempts
+    AttemptThrottle bindingThrottle{FSTORAGE_KEY("thr_bndg")};
+    AttemptThrottle unlockControlThrottle{FSTORAGE_KEY("thr_ucpin")};
     bool isStandAloneMode = false;
 
-    // BLE system objects
+    // BLE system objects (created once and reused on restart, see BLELifecycle.cpp)
     BLEService *pService = nullptr;
     BLECharacteristic *pTxCharacteristic = nullptr;
     BLECharacteristic *pRxCharacteristic = nullptr;
+    bool bleObjectsOutdated = false;
+
+    // BLE lifecycle
+    BLELifecycleState bleState = BLE_STATE_STOPPED;
+    bool bleStartRequested = false;
+    bool bleRestartRequested = false;
+    bool bleRestartPending = false;
+    unsigned long bleStateDeadline = 0;
+    unsigned long bleStateEntryTime = 0;
+    unsigned long bleRestartRequestTime = 0;
+    BLELIFECYCLESTATISTICS bleStatistics = {};
+
+    // BLE profiles
+    BLEPROFILEPARAMETERS bleProfiles[BLE_PROFILE_COUNT] = {
+        { 160, 0, 0 },      // balanced: advertising every 100 ms, connection interval of the stack
+        { 32, 6, 12 },      // low latency: advertising every 20 ms, connection interval 7.5 - 15 ms
+        { 1600, 80, 160 }   // power saving: advertising every 1 s, connection interval 100 - 200 ms
+    };
+    BLEProfile selectedBleProfile = BLE_PROFILE_BALANCED;
+    BLEProfile activeBleProfile = BLE_PROFILE_BALANCED;
+    BLEPROFILEPARAMETERS activeBleProfileParameters = {};
+    bool automaticBleProfile = false;
+    bool bleProfileChanged = false;
+    unsigned long bleProfileChangeCount = 0;
 
     TransmissionControl tmc;
+    String rxData;
+
+    // scheduler and library tasks
+    TaskScheduler scheduler;
+    int protocolTask = INVALID_TASK_HANDLE;
+    int storageTask = INVALID_TASK_HANDLE;
+    int snapshotTask = INVALID_TASK_HANDLE;
+    unsigned long protocolPollInterval = LAROOMY_PROTOCOL_POLL_INTERVAL;
+
+    // protocol thread (see ProtocolThread.cpp), the queues are shared with the application thread and guarded by the mutex
+    rtos::Thread* pProtocolThread = nullptr;
+    rtos::Mutex queueMutex;
+    rtos::EventFlags protocolThreadFlags;
+    volatile bool protocolThreadRunning = false;
+    FixedQueue<TRANSMISSIONSLOT, LAROOMY_TX_QUEUE_DEPTH> txQueue;
+    FixedQueue<PROTOCOLEVENT, LAROOMY_EVENT_QUEUE_DEPTH> eventQueue;
+    unsigned int txQueueOverflowCount = 0;
+
+    // event queue mode (see PropertyEvents.cpp), only accessed on the application thread
+    bool eventQueueMode = false;
+    FixedQueue<PROPERTYEVENT, LAROOMY_PROPERTY_EVENT_QUEUE_DEPTH> propertyEventQueue;
+    uint32_t eventCoalescingMask =
+        (1UL << PropertyType::LEVEL_SELECTOR) | (1UL << PropertyType::EX_LEVEL_SELECTOR) | (1UL << PropertyType::RGB_SELECTOR);
+    unsigned int droppedEventCount = 0;
+    unsigned int coalescedEventCount = 0;
+
+    // holds the descriptors of the properties and groups
+    StringArena stringArena;
     String lastLangID = "en";
     unsigned int deviceImageID = 0;
 
     // callback for remote user events and descriptions
     ILaroomyAppCallback *pLrCallback = nullptr;
     IElementDescriptionCallback *pDescriptionCallback = nullptr;
+    RGBZoneControl *pRgbZoneControl = nullptr;
 
     // config parameters
     bool cachingPermission = false;
     bool deviceBindingAuthenticationRequired = false;
-    bool propertyLoadingDone = true;
+    // reset on disconnection (by the connection handler, on the protocol thread in thread mode)
+    volatile bool propertyLoadingDone = true;
     cID currentPropertyPageID = ID_DEVICE_MAIN_PAGE;
 
+    // state persistence
+    bool statePersistenceEnabled = false;
+    bool stateSnapshotPending = false;
+    unsigned long stateSnapshotDebounceTime = LAROOMY_STATE_SNAPSHOT_DEBOUNCE_TIME;
+    uint32_t lastSnapshotChecksum = 0;
+
+    // state resume (see StateResume.cpp)
+    bool stateResumeEnabled = false;
+    bool stateResumeValid = false;
+    uint32_t stateSequence = 0;
+    unsigned int lastResumedStateCount = 0;
+
     // properties & groups
+#ifdef LAROOMY_STATIC_ALLOCATION
+    // in static allocation mode the collections are located in static memory (see LaRoomyApi_STM32.cpp)
+    fixedItemCollection<DeviceProperty, LAROOMY_MAX_PROPERTIES>& deviceProperties;
+    fixedItemCollection<DevicePropertyGroup, LAROOMY_MAX_GROUPS>& devicePropertyGroups;
+
+    // complex property states
+    fixedItemCollection<RGBSelectorState, LAROOMY_MAX_COMPLEX_STATES>& rgbStates;
+    fixedItemCollection<ExtendedLevelSelectorState, LAROOMY_MAX_COMPLEX_STATES>& extendedLevelStates;
+    fixedItemCollection<TimeSelectorState, LAROOMY_MAX_COMPLEX_STATES>& timeSelectorStates;
+    fixedItemCollection<TimeFrameSelectorState, LAROOMY_MAX_COMPLEX_STATES>& timeFrameSelectorStates;
+    fixedItemCollection<DateSelectorState, LAROOMY_MAX_COMPLEX_STATES>& dateSelectorStates;
+    fixedItemCollection<UnlockControlState, LAROOMY_MAX_COMPLEX_STATES>& unlockControlStates;
+    fixedItemCollection<NavigatorState, LAROOMY_MAX_COMPLEX_STATES>& navigatorStates;
+    fixedItemCollection<BarGraphState, LAROOMY_MAX_COMPLEX_STATES>& barGraphStates;
+    fixedItemCollection<LineGraphState, LAROOMY_MAX_COMPLEX_STATES>& lineGraphStates;
+    fixedItemCollection<StringInterrogatorState, LAROOMY_MAX_COMPLEX_STATES>& stringInterrogatorStates;
+    fixedItemCollection<TextListPresenterState, LAROOMY_MAX_COMPLEX_STATES>& textListPresenterStates;
+#else
     itemCollection<DeviceProperty> deviceProperties;
     itemCollection<DevicePropertyGroup> devicePropertyGroups;
 
@@ -927,6 +1572,7 @@ private:
     itemCollection<LineGraphState> lineGraphStates;
     itemCollection<StringInterrogatorState> stringInterrogatorStates;
     itemCollection<TextListPresenterState> textListPresenterStates;
+#endif
 
     // connect callback methods
     static void connectHandler(BLEDevice central);
@@ -935,14 +1581,43 @@ private:
     // characterisic callback method
     static void characteristicWritten(BLEDevice central, BLECharacteristic characteristic);
 
-    // ble send data method
-    void sendData(const String& data);
+    // scheduler tasks
+    void registerTasks();
+    void processTransmissions();
+    static void protocolTaskFunction(void* context);
+    static void storageTaskFunction(void* context);
+    static void snapshotTaskFunction(void* context);
+
+    // protocol thread
+    void protocolThreadFunction();
+    void releaseProtocolThread();
+    bool reserveTransmissionSlots(unsigned int count);
+    bool transmit(const char* data);
+    void transmitQueuedData();
+    bool receiveTransmission();
+    void postProtocolEvent(const PROTOCOLEVENT& event);
+    void dispatchProtocolEvents();
+
+    // event queue mode
+    bool queuePropertyEvent(const DeviceProperty* property, const uint8_t* data, uint8_t size, uint8_t trackingType = 0);
+
+    // invoke the property handler or the callback interface, the state type depends on the property type (simple states: uint8_t, button: none)
+    void deliverPropertyEvent(cID propertyID, unsigned int propertyType, PropertyHandler handler, void* context, void* state);
+    void deliverPropertyEvent(const DeviceProperty* property, void* state);
+
+    // property handler
+    bool registerPropertyHandler(cID propertyID, PropertyHandler handler, void* context, PropertyType type, PropertyType alternativeType = PropertyType::PTYPE_INVALID);
+
+    // ble send data method, returns false if the data was not sent (not connected or the transmission queue is full)
+    bool sendData(const String& data);
 
     // private property add
     void _addDeviceProperty(const DeviceProperty& p, bool sendCommand);
+    void _addDeviceProperty(DeviceProperty&& p, bool sendCommand);
+    DeviceProperty propertyFromTableEntry(const PropertyTableEntry& entry);
 
     // state init methods
-    void initializeComplexPropertyState(const DeviceProperty& p);
+    void initializeComplexPropertyState(cID propertyID);
     void initDefaultRGBState(cID propertyID);
     void initRGBStateFromInitialStateString(cID propertyID, const String &iss);
     void initDefaultExLevelState(cID propertyID);
@@ -975,17 +1650,31 @@ private:
     void onBindingTransmission(const String& data);
     void onNotificationTransmission(const String& data);
 
-    void ble_start();
-    void ble_restart();
+    // bluetooth lifecycle (see BLELifecycle.cpp)
+    bool ble_createObjects();
+    void ble_releaseObjects();
+    void ble_processLifecycle();
+    void ble_enterState(BLELifecycleState state, unsigned long transitionTime);
     void ble_terminate();
+    BLEProfile ble_selectProfile();
+    void ble_applyProfile(BLEProfile profile, bool restartAdvertising);
+
+    // the stack is initialized and can be polled
+    bool ble_isActive(){
+        return (this->bleState != BLE_STATE_STOPPED) ? true : false;
+    }
 
     // helper
+    // move the descriptor of the stored element to the string arena (previousRef: the arena slot to reuse if the descriptor fits in)
+    void bindPropertyDescriptorToArena(unsigned int index, const char* previousRef = nullptr);
+    void bindGroupDescriptorToArena(unsigned int index);
+
     unsigned int propertyIndexFromPropertyID(unsigned int pId);
     unsigned int propertyTypeFromPropertyIndex(unsigned int propertyIndex);
     unsigned int propertyIDFromPropertyIndex(unsigned int propertyIndex);
     unsigned int groupIndexFromGroupID(cID groupID);
     bool validatePropertyID(cID pID);
-    void applyDeviceImageIDToBluetoothName();
+    String getAdvertisedBluetoothName();
     void rearrangeGroupIndexes();
     
     // internal update methods
@@ -1002,8 +1691,50 @@ private:
     void _updateStringInterrogatorState(StringInterrogatorState& state, bool send);
     void _updateTextListPresenterState(TextListPresenterState& state, bool send);
 
+    // state persistence (see StatePersistence.cpp)
+    void onPropertyStateChanged(cID propertyID, bool synchronized = false);
+    unsigned int createStateSnapshot(uint8_t* buffer, unsigned int size);
+    void applyStateSnapshot(const uint8_t* data, unsigned int size);
+
+    // state resume (see StateResume.cpp)
+    void trackStateChange(cID propertyID, bool synchronized);
+    void markStateSynchronized(unsigned int propertyIndex);
+    void onPropertyStructureChanged();
+    bool resumeChangedStates();
+    bool sendStateUpdate(unsigned int propertyIndex);
+    bool sendSimpleStateUpdate(unsigned int propertyIndex, unsigned int value);
+
     void sendBindingResponse(BindingResponseType t);
+    void onBindingAuthenticationResult(BindingResponseType result);
     bool checkUnlockControlPin(UnlockControlState& state);
+    bool verifyUnlockControlPin(cID unlockControlID, const char* pin, size_t length);
+
+    // get the stored complex state of the given property or nullptr if there is none
+    template<class C>
+    static auto findStoredState(C& collection, cID propertyID) -> decltype(collection.getObjectCoreReferenceAt(0)){
+        for(unsigned int i = 0; i < collection.GetCount(); i++){
+            if(collection.getObjectCoreReferenceAt(i)->associatedPropertyID == propertyID){
+                return collection.getObjectCoreReferenceAt(i);
+            }
+        }
+        return nullptr;
+    }
+
+    // record the change and send the update transmission for a state modified in place
+    template<class S>
+    void commitStateModification(S& state, bool send){
+        this->onPropertyStateChanged(state.associatedPropertyID);
+
+        if(this->is_connected && send){
+            auto index = this->propertyIndexFromPropertyID(state.associatedPropertyID);
+
+            if(this->sendData(state.toStateString(index, TransmissionSubType::UPDATE))){
+                this->markStateSynchronized(index);
+            }
+        }
+    }
+
+    template<class S> friend class StateModifier;
 };
 
 /**
@@ -1012,6 +1743,58 @@ private:
  */
 #define LaRoomyApi (*LaRoomyAppImplementation::GetInstance())
 
+/**
+ * @brief Scoped handle to a stored complex property state (see LaRoomyAppImplementation::modifyRGBState(...) etc.).
+ * The state is modified in place, the update transmission is sent when the handle is released or goes out of scope.
+ */
+template<class S>
+class StateModifier {
+    friend LaRoomyAppImplementation;
+public:
+    StateModifier(StateModifier&& m)
+        : pApi(m.pApi), pState(m.pState)
+    {
+        m.pState = nullptr;
+    }
+    StateModifier(const StateModifier&) = delete;
+    StateModifier& operator=(const StateModifier&) = delete;
+
+    ~StateModifier(){
+        this->release();
+    }
+
+    // check if the state was found
+    bool isValid() const {
+        return this->pState != nullptr;
+    }
+
+    S* operator->(){
+        return this->pState;
+    }
+    S& operator*(){
+        return *this->pState;
+    }
+
+    /**
+     * @brief Finish the modification. After this call the handle is invalid.
+     * 
+     * @param send Set to false to suppress the update transmission (the modification is kept)
+     */
+    void release(bool send = true){
+        if(this->pState != nullptr){
+            this->pApi->commitStateModification(*this->pState, send);
+            this->pState = nullptr;
+        }
+    }
+
+private:
+    StateModifier(LaRoomyAppImplementation* api, S* state)
+        : pApi(api), pState(state) {}
+
+    LaRoomyAppImplementation* pApi;
+    S* pState;
+};
+
 /**
  * @brief The device-property base class. Use this to constuct a property or use a specific property-type-class
  * 
@@ -1023,6 +1806,9 @@ public:
     DeviceProperty(const DeviceProperty& p){
         this->copy(p);
     }
+    DeviceProperty(DeviceProperty&& p){
+        this->move(p);
+    }
     DeviceProperty(Button &b);
     DeviceProperty(Switch &s);
     DeviceProperty(LevelSelector &ls);
@@ -1044,12 +1830,21 @@ public:
     ~DeviceProperty();
 
     DeviceProperty& operator= (const DeviceProperty& p){
-        this->copy(p);
+        if(this != &p){
+            this->copy(p);
+        }
+        return *this;
+    }
+
+    DeviceProperty& operator= (DeviceProperty&& p){
+        if(this != &p){
+            this->move(p);
+        }
         return *this;
     }
 
-	bool operator== (const DeviceProperty& p){
-        if((this->propertyType == p.propertyType) && (this->imageID == p.imageID) && (this->descriptor == p.descriptor)
+	bool operator== (const DeviceProperty& p) const {
+        if((this->propertyType == p.propertyType) && (this->imageID == p.imageID) && (strcmp(this->descriptorData(), p.descriptorData()) == 0)
             && (this->groupIndex == p.groupIndex) && (this->flags == p.flags)){
                 return true;
             }
@@ -1078,9 +1873,31 @@ private:
     LineGraphState* lineGraphStateHolder = nullptr;
     StringInterrogatorState* stringInterrogatorStateHolder = nullptr;
 
+    // view to the descriptor in the string arena of the api, only used if the descriptor string is empty
+    const char* descriptorRef = nullptr;
+
+    // the handler registered by LaRoomyAppImplementation::setPropertyHandler(...)
+    PropertyHandler handler = nullptr;
+    void* handlerContext = nullptr;
+
+    // the state sequence number of the last state change and of the last state known by the app (see LaRoomyAppImplementation::enableStateResume(...))
+    uint32_t changeSequence = 0;
+    uint32_t syncedSequence = 0;
+
+    // get the effective descriptor (the string or the arena view)
+    const char* descriptorData() const {
+        return arenaStringData(this->descriptor, this->descriptorRef);
+    }
+
+    // copy the arena view back to the descriptor string (the object is no longer bound to the arena)
+    void materializeDescriptor(){
+        materializeArenaString(this->descriptor, this->descriptorRef);
+    }
+
     void updateFlags();
     String toTransmissionString(TransmissionSubType t, unsigned int propertyIndex);
     void copy(const DeviceProperty& p);
+    void move(DeviceProperty& p);
     void clearStateHolder();
 };
 
@@ -1095,13 +1912,17 @@ public:
     DevicePropertyGroup(const DevicePropertyGroup& g){
         this->copy(g);
     }
+    DevicePropertyGroup(DevicePropertyGroup&& g) = default;
 
     DevicePropertyGroup& operator= (const DevicePropertyGroup& g){
-        this->copy(g);
+        if(this != &g){
+            this->copy(g);
+        }
         return *this;
     }
-    bool operator== (const DevicePropertyGroup& g){
-        if((this->imageID == g.imageID) && (this->descriptor == g.descriptor) && (this->propertyList.GetCount() == g.propertyList.GetCount()) && (this->groupID == g.groupID)){
+    DevicePropertyGroup& operator= (DevicePropertyGroup&& g) = default;
+    bool operator== (const DevicePropertyGroup& g) const {
+        if((this->imageID == g.imageID) && (strcmp(this->descriptorData(), g.descriptorData()) == 0) && (this->propertyList.GetCount() == g.propertyList.GetCount()) && (this->groupID == g.groupID)){
             return true;
         }
         else {
@@ -1118,6 +1939,15 @@ public:
         this->propertyList.AddItem(p);
     }
 
+    /**
+     * @brief Add a deviceProperty to this group by moving its content
+     * 
+     * @param p The property to add (it is empty after the call)
+     */
+    void addDeviceProperty(DeviceProperty&& p){
+        this->propertyList.AddItem(std::move(p));
+    }
+
     String descriptor = "not set";
 
     unsigned int imageID = 0;
@@ -1127,11 +1957,25 @@ private:
     itemCollection<DeviceProperty> propertyList;
     unsigned int propertyCount = 0;
 
+    // view to the descriptor in the string arena of the api, only used if the descriptor string is empty
+    const char* descriptorRef = nullptr;
+
+    // get the effective descriptor (the string or the arena view)
+    const char* descriptorData() const {
+        return arenaStringData(this->descriptor, this->descriptorRef);
+    }
+
+    // copy the arena view back to the descriptor string (the object is no longer bound to the arena)
+    void materializeDescriptor(){
+        materializeArenaString(this->descriptor, this->descriptorRef);
+    }
+
     String toTransmissionString(TransmissionSubType t, unsigned int groupIndex);
 
     void copy(const DevicePropertyGroup& g){
         // this->descriptor = "";
         this->descriptor = g.descriptor;
+        this->descriptorRef = g.descriptorRef;
         this->imageID = g.imageID;
         this->propertyList.Clear();
         this->propertyList = g.propertyList;
@@ -1146,6 +1990,27 @@ private:
  */
 typedef itemCollection<COLOR> ColorCollection;
 
+// the progress of a fade in 16 bit fixed point, this value marks the completion
+#define RGB_FADE_PROGRESS_COMPLETE  0x10000UL
+
+// repeat count of a keyframe program which runs until it is stopped
+#define RGB_KEYFRAME_REPEAT_INFINITE    0
+
+/**
+ * @brief Keyframe of a color program for RGBControl::runKeyframeProgram(...). The output fades to the color in 'fadeTime' and holds it for 'holdTime',
+ * then the next keyframe starts. A program is a constant array of keyframes, so it is stored in flash.
+ * Example: static const RGBKEYFRAME show[] = { { 255, 0, 0, FADE_EASE_IN_OUT, 500, 1000 }, { 0, 0, 255, FADE_LINEAR, 0, 250 } };
+ * 
+ */
+typedef struct _RGBKEYFRAME {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    uint8_t easing;         // RGBFadeEasing
+    uint16_t fadeTime;      // milliseconds, 0 is a hard transition
+    uint16_t holdTime;      // milliseconds
+} RGBKEYFRAME, *PRGBKEYFRAME;
+
 /**
  * @brief Worker-Class for the control of rgb output
  * 
@@ -1161,32 +2026,69 @@ public:
      */
     RGBControl(pin_size_t RedPin, pin_size_t GreenPin, pin_size_t BluePin);
 
+    /**
+     * @brief Construct a new RGBControl object with a custom output backend (e.g. LEDStripOutput)
+     * 
+     * @param output The output, must remain valid while the object exists
+     */
+    RGBControl(RGBOutput& output);
+
     ~RGBControl();
 
     /**
-     * @brief Start RGB control on the specified pins
+     * @brief Start RGB control on the specified pins or output
      */
     void begin();
 
     /**
-     * @brief End the RGB control on the specified pins
+     * @brief End the RGB control on the specified pins or output
      * 
      */
     void end();
 
     /**
      * @brief Set the Fade Delay Value in milliseconds.
-     * NOTE: The fading is generated by increasing or decreasing the current value until is reaches the desired value.
-     * This value is the delay before the next single increasing or decreasing action will be taken. Example: when fading from OFF to full RED color, the
+     * NOTE: The fading interpolates all channels from the start color to the target color, so all channels reach the target at the same time.
+     * This value is the interval between two output updates. If no fade duration is set (see setFadeDuration(...)), the duration of a fade is
+     * this value multiplied by the largest channel difference. Example: when fading from OFF to full RED color, the
      * Red-Value 0 must be increased to 255. So this delay value is applied 255 times. If this value is set to 10 milliseconds, the fade takes up to 2,55 seconds.
      * The default value is 3 milliseconds, this makes 765 millis fading time.
      * 
-     * @param fadeDelay The delay before the next increasing or decreasing action will be applied.
+     * @param fadeDelay The delay before the next update of the output will be applied.
      */
     void setFadeDelayValue(unsigned int fadeDelay){
         this->fadeTimeOut = (unsigned long)fadeDelay;
     }
 
+    /**
+     * @brief Set a fixed duration for the color transitions (soft transitions only), independent of the color difference.
+     * Takes effect with the next color change.
+     * 
+     * @param duration The duration in milliseconds, 0 (default) derives the duration from the fade delay value and the color difference
+     */
+    void setFadeDuration(unsigned long duration){
+        this->fadeDuration = duration;
+    }
+
+    /**
+     * @brief Set the easing curve of the color transitions. Takes effect with the next color change.
+     * 
+     * @param easing Type: RGBFadeEasing Enum - FADE_LINEAR (default), FADE_EASE_IN, FADE_EASE_OUT or FADE_EASE_IN_OUT
+     */
+    void setFadeEasing(RGBFadeEasing easing){
+        this->fadeEasing = easing;
+    }
+
+    /**
+     * @brief Enable the gamma correction (2.2) of the output values, so that the perceived brightness changes evenly during a fade.
+     * NOTE: The color values (e.g. from the RGBSelectorState) remain linear, only the PWM output is corrected.
+     * 
+     * @param enable True to enable the correction
+     */
+    void enableGammaCorrection(bool enable){
+        this->gammaCorrection = enable;
+    }
+
     /**
      * @brief Disable all output on the RGB pins.
      * 
@@ -1237,10 +2139,71 @@ public:
     void changeRGBProgram(RGBColorTransitionProgram program, RGBTransitionType tType);
 
     /**
-     * @brief The method must be placed inside the main-loop to handle desired output and timing features
+     * @brief Run a program of keyframes. The program is executed by onLoop() (or the scheduler task) with constant cost per call,
+     * the application does not need to interact until the program ends. The fade delay value remains the update interval of the fades.
+     * NOTE: The keyframe array is not copied, it must remain valid while the program runs. A color change or a program change stops the keyframe program.
+     * 
+     * @param keyframes The keyframe array (at least one element)
+     * @param count The number of keyframes
+     * @param repeatCount The number of program runs, RGB_KEYFRAME_REPEAT_INFINITE runs the program until it is stopped
+     * @return true if the program was started, false if the array is empty or a keyframe has an invalid easing value
+     */
+    bool runKeyframeProgram(const RGBKEYFRAME* keyframes, unsigned int count, unsigned int repeatCount = RGB_KEYFRAME_REPEAT_INFINITE);
+
+    /**
+     * @brief Stop the keyframe program, the current color remains
+     * 
+     */
+    void stopKeyframeProgram();
+
+    // check if a keyframe program is running
+    bool isKeyframeProgramActive() const {
+        return (this->pKeyframes != nullptr) ? true : false;
+    }
+
+    /**
+     * @brief The method must be placed inside the main-loop to handle desired output and timing features.
+     * Not required if the object is attached to a scheduler.
+     * 
+     * @return unsigned long - the time in milliseconds until the next output change, SCHEDULER_NO_DEADLINE if the output is static
+     */
+    unsigned long onLoop();
+
+    /**
+     * @brief Execute the output handling as task of the scheduler instead of calling onLoop() in the main-loop.
+     * The task is only scheduled while a fading or a program is active. Example: rgb.attachToScheduler(LaRoomyApi.getScheduler());
+     * NOTE: Call detachFromScheduler() before the scheduler is destroyed (e.g. before LaRoomyApi.end()).
+     * 
+     * @param scheduler The scheduler
+     * @return true if the task was added
+     */
+    bool attachToScheduler(TaskScheduler& scheduler);
+
+    /**
+     * @brief Remove the task from the scheduler
+     * 
+     */
+    void detachFromScheduler();
+
+    /**
+     * @brief Drive the fading by a timer interrupt instead of polling in onLoop(). On each color change the fade is precomputed,
+     * the interrupt (period: fade delay value) only advances the fixed-point progress and applies the interpolated values to the PWM outputs,
+     * so the fading is smooth regardless of the loop timing. The program color changes are still handled in onLoop() (or the scheduler task).
+     * NOTE: The outputs are initialized in begin(), so the interrupt does not allocate memory. The mode requires an interrupt-safe output backend
+     *       (see RGBOutput::isInterruptSafe()), with LEDStripOutput the fading remains in onLoop().
      * 
+     * @param enable True to enable the timer driven fading
+     * @param useInternalTicker True to use an internal mbed::Ticker, false to call onFadeTick() from another time source
+     * @return true if successful, false if the output backend is not interrupt-safe
      */
-    void onLoop();
+    bool enableTimerDrivenFading(bool enable, bool useInternalTicker = true);
+
+    /**
+     * @brief Apply the next fade step. Called by the internal ticker in timer driven mode, if the internal ticker is not used,
+     * call it with the period of the fade delay value (interrupt-safe).
+     * 
+     */
+    void onFadeTick();
 
 private:
     uint8_t redValue = 0;
@@ -1251,10 +2214,9 @@ private:
     uint8_t currentGreenValue = 0;
     uint8_t currentBlueValue = 0;
 
-    pin_size_t redPin = 0;
-    pin_size_t greenPin = 0;
-    pin_size_t bluePin = 0;
-    
+    PWMOutput pwmOutput;
+    RGBOutput* pOutput;
+
     bool hardTrans = false;
     bool hasBegun = false;
     unsigned int currentColorIndex = 0;
@@ -1268,6 +2230,190 @@ private:
     unsigned long tmSaver = 0;
 
     RGBColorTransitionProgram tProgram = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
+
+    TaskScheduler* pScheduler = nullptr;
+    int taskHandle = INVALID_TASK_HANDLE;
+
+    // fade parameter
+    unsigned long fadeDuration = 0;
+    RGBFadeEasing fadeEasing = RGBFadeEasing::FADE_LINEAR;
+    bool gammaCorrection = false;
+
+    // keyframe program
+    const RGBKEYFRAME* pKeyframes = nullptr;
+    unsigned int keyframeCount = 0;
+    unsigned int keyframeIndex = 0;
+    unsigned int keyframeRepeatCount = 0;
+    unsigned int keyframeRunCount = 0;
+    unsigned long keyframeTimer = 0;
+    unsigned long keyframeStepTime = 0;
+
+    // the current fade, written with interrupts disabled and executed by onLoop() or onFadeTick()
+    uint8_t fadeStartValues[3] = { 0, 0, 0 };
+    int16_t fadeDelta[3] = { 0, 0, 0 };
+    unsigned long fadeStartTime = 0;
+    unsigned long activeFadeDuration = 0;
+    RGBFadeEasing activeFadeEasing = RGBFadeEasing::FADE_LINEAR;
+    volatile uint32_t fadeProgress = RGB_FADE_PROGRESS_COMPLETE;
+    uint32_t fadeProgressStep = 0;
+
+    // timer driven fading
+    bool timerDrivenFading = false;
+    bool useFadeTicker = false;
+    mbed::Ticker fadeTicker;
+
+    void onOutputChanged();
+    void startFade();
+    void applyFadeProgress(uint32_t progress);
+    void startKeyframe(unsigned long now);
+    static void taskFunction(void* context);
+};
+
+/**
+ * @brief Worker-Class for the control of multiple rgb outputs (zones). The zone data is stored as struct of arrays and all fades are advanced
+ * in one pass with one time query, so the cost per loop is lower than with one RGBControl object per zone.
+ * Each zone can be bound to a RGBSelector property, register the object with LaRoomyApi.setRGBZoneControl(...) to apply the state changes
+ * of bound RGBSelectors automatically. The capacity is LAROOMY_MAX_RGB_ZONES.
+ * 
+ */
+class RGBZoneControl {
+public:
+    ~RGBZoneControl();
+
+    /**
+     * @brief Add a zone
+     * 
+     * @param redPin The output pin for the red value
+     * @param greenPin The output pin for the green value
+     * @param bluePin The output pin for the blue value
+     * @param rgbSelectorID The ID of the RGBSelector property to bind the zone to (optional)
+     * @return int - the zone index or -1 if the capacity is exhausted
+     */
+    int addZone(pin_size_t redPin, pin_size_t greenPin, pin_size_t bluePin, cID rgbSelectorID = ID_NOT_BOUND);
+
+    /**
+     * @brief Bind a zone to a RGBSelector property, multiple zones can be bound to the same property
+     * 
+     * @param zone The zone index
+     * @param rgbSelectorID The ID of the RGBSelector, ID_NOT_BOUND to remove the binding
+     */
+    void bindZone(unsigned int zone, cID rgbSelectorID);
+
+    unsigned int getZoneCount(){
+        return this->zoneCount;
+    }
+
+    /**
+     * @brief Start the control, configures the pins of all zones
+     */
+    void begin();
+
+    /**
+     * @brief End the control, all outputs are switched off
+     */
+    void end();
+
+    /**
+     * @brief Change the color of a zone. NOTE: If a program is active on the zone, it will be stopped.
+     * 
+     * @param zone The zone index
+     * @param red Type: uint8_t - The red color value
+     * @param green Type: uint8_t - The green color value
+     * @param blue Type: uint8_t - The blue color value
+     * @param tType Type: RGBTransitionType Enum - Defines if a fading to the new value should occur or if the transition should happen immediately
+     */
+    void changeZoneColor(unsigned int zone, uint8_t red, uint8_t green, uint8_t blue, RGBTransitionType tType = RGBTransitionType::SOFT_TRANSITION);
+
+    /**
+     * @brief Start a color transition program on a zone (see RGBControl::changeRGBProgram(...))
+     */
+    void changeZoneProgram(unsigned int zone, RGBColorTransitionProgram program, RGBTransitionType tType);
+
+    // disable the output of a zone
+    void zoneOff(unsigned int zone);
+
+    // set the output of a zone from a RGBSelectorState class object
+    void applyStateChange(unsigned int zone, const RGBSelectorState& state);
+
+    /**
+     * @brief Apply the state to all zones bound to the RGBSelector. Called by the LaRoomyApi if the object is registered.
+     * 
+     * @param rgbSelectorID The ID of the RGBSelector
+     * @param state The new state
+     * @return true if at least one zone is bound to the RGBSelector
+     */
+    bool applyBoundStateChange(cID rgbSelectorID, const RGBSelectorState& state);
+
+    // the fade parameter of all zones (see RGBControl)
+    void setFadeDelayValue(unsigned int fadeDelay){
+        this->fadeTimeOut = (unsigned long)fadeDelay;
+    }
+    void setFadeDuration(unsigned long duration){
+        this->fadeDuration = duration;
+    }
+    void setFadeEasing(RGBFadeEasing easing){
+        this->fadeEasing = easing;
+    }
+    void enableGammaCorrection(bool enable){
+        this->gammaCorrection = enable;
+    }
+
+    // the color collection for the programs of all zones
+    void setCustomColorSelection(ColorCollection& colorSel);
+
+    /**
+     * @brief The method must be placed inside the main-loop to handle the output of all zones. Not required if the object is attached to a scheduler.
+     * 
+     * @return unsigned long - the time in milliseconds until the next output change, SCHEDULER_NO_DEADLINE if all outputs are static
+     */
+    unsigned long onLoop();
+
+    /**
+     * @brief Execute the output handling as task of the scheduler (see RGBControl::attachToScheduler(...))
+     * NOTE: Call detachFromScheduler() before the scheduler is destroyed.
+     */
+    bool attachToScheduler(TaskScheduler& scheduler);
+    void detachFromScheduler();
+
+private:
+    unsigned int zoneCount = 0;
+    bool hasBegun = false;
+
+    // zone data (index: [channel][zone])
+    pin_size_t pins[3][LAROOMY_MAX_RGB_ZONES];
+    uint8_t currentValues[3][LAROOMY_MAX_RGB_ZONES];
+    uint8_t fadeStartValues[3][LAROOMY_MAX_RGB_ZONES];
+    int16_t fadeDelta[3][LAROOMY_MAX_RGB_ZONES];
+    unsigned long fadeStartTime[LAROOMY_MAX_RGB_ZONES];
+    unsigned long activeFadeDuration[LAROOMY_MAX_RGB_ZONES];
+    cID boundSelectorIDs[LAROOMY_MAX_RGB_ZONES];
+
+    // program data, the program fades use the delay of the program instead of the fade delay value
+    RGBColorTransitionProgram programs[LAROOMY_MAX_RGB_ZONES];
+    unsigned long programTimers[LAROOMY_MAX_RGB_ZONES];
+    unsigned int colorIndexes[LAROOMY_MAX_RGB_ZONES];
+
+    // bit masks of the zones with an active fade / program / hard transition
+    uint32_t fadeMask = 0;
+    uint32_t programMask = 0;
+    uint32_t hardTransitionMask = 0;
+
+    ColorCollection colorSelection;
+
+    unsigned long fadeTimer = 0;
+    unsigned long fadeTimeOut = 3;
+    unsigned long fadeDuration = 0;
+    RGBFadeEasing fadeEasing = RGBFadeEasing::FADE_LINEAR;
+    bool gammaCorrection = false;
+
+    TaskScheduler* pScheduler = nullptr;
+    int taskHandle = INVALID_TASK_HANDLE;
+
+    void startZoneFade(unsigned int zone, uint8_t red, uint8_t green, uint8_t blue, unsigned long fadeDelay, bool hardTransition);
+    void nextProgramColor(unsigned int zone);
+    void writeZone(unsigned int zone);
+    void wakeTask();
+    static void taskFunction(void* context);
 };
 
 /**
@@ -1340,8 +2486,8 @@ public:
 
     RGBSelectorState& operator= (const RGBSelectorState& state);
     RGBSelectorState& operator= (const COLOR& col);
-    bool operator== (const RGBSelectorState& state);
-    bool operator!= (const RGBSelectorState& state);
+    bool operator== (const RGBSelectorState& state) const;
+    bool operator!= (const RGBSelectorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1349,6 +2495,10 @@ private:
     String toStateString(unsigned int propertyIndex, TransmissionSubType t);
     void fromExecutionString(const String& data);
     void copy(const RGBSelectorState& s);
+
+    // compact binary form for the state snapshot (returns the number of bytes written, the buffer must hold STATE_BINARY_MAX_SIZE bytes)
+    uint8_t toBinary(uint8_t* buffer) const;
+    bool fromBinary(const uint8_t* data, uint8_t size);
 };
 
 /**
@@ -1373,8 +2523,8 @@ public:
     ExLevelTrackingType trackingType = ExLevelTrackingType::ELTT_UNUSED;
 
     ExtendedLevelSelectorState& operator=(const ExtendedLevelSelectorState& state);
-    bool operator==(const ExtendedLevelSelectorState& state);
-    bool operator!=(const ExtendedLevelSelectorState& state);
+    bool operator==(const ExtendedLevelSelectorState& state) const;
+    bool operator!=(const ExtendedLevelSelectorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1384,6 +2534,9 @@ private:
 
     void fromExecutionString(const String& data);
     void copy(const ExtendedLevelSelectorState& state);
+
+    uint8_t toBinary(uint8_t* buffer) const;
+    bool fromBinary(const uint8_t* data, uint8_t size);
 };
 
 /**
@@ -1490,10 +2643,10 @@ public:
     unsigned int hour = 0;
     unsigned int minute = 0;
 
-    STATETIME toStateTime();
+    STATETIME toStateTime() const;
     TimeSelectorState& operator=(const TimeSelectorState& state);
-    bool operator==(const TimeSelectorState& state);
-    bool operator!=(const TimeSelectorState& state);
+    bool operator==(const TimeSelectorState& state) const;
+    bool operator!=(const TimeSelectorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1501,6 +2654,9 @@ private:
     String toStateString(unsigned int propertyIndex, TransmissionSubType t);
     void fromExecutionString(const String& data);
     void copy(const TimeSelectorState& state);
+
+    uint8_t toBinary(uint8_t* buffer) const;
+    bool fromBinary(const uint8_t* data, uint8_t size);
 };
 
 /**
@@ -1519,10 +2675,10 @@ public:
     STATETIME startTime = {0,0};
     STATETIME endTime = {0,0};
 
-    bool checkIfTimeIsInFrame(const STATETIME& pTime);
+    bool checkIfTimeIsInFrame(const STATETIME& pTime) const;
     TimeFrameSelectorState& operator=(const TimeFrameSelectorState& state);
-    bool operator==(const TimeFrameSelectorState& state);
-    bool operator!=(const TimeFrameSelectorState& state);
+    bool operator==(const TimeFrameSelectorState& state) const;
+    bool operator!=(const TimeFrameSelectorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1530,6 +2686,9 @@ private:
     String toStateString(unsigned int propertyIndex, TransmissionSubType t);
     void fromExecutionString(const String& data);
     void copy(const TimeFrameSelectorState& state);
+
+    uint8_t toBinary(uint8_t* buffer) const;
+    bool fromBinary(const uint8_t* data, uint8_t size);
 };
 
 /**
@@ -1550,8 +2709,8 @@ public:
     unsigned int year = 2023;
 
     DateSelectorState& operator=(const DateSelectorState& state);
-    bool operator==(const DateSelectorState& state);
-    bool operator!=(const DateSelectorState& state);
+    bool operator==(const DateSelectorState& state) const;
+    bool operator!=(const DateSelectorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1560,6 +2719,9 @@ private:
     void fromExecutionString(const String& data);
     void copy(const DateSelectorState& state);
 
+    uint8_t toBinary(uint8_t* buffer) const;
+    bool fromBinary(const uint8_t* data, uint8_t size);
+
 };
 
 /**
@@ -1574,14 +2736,16 @@ public:
     UnlockControlState(const UnlockControlState& state){
         this->copy(state);
     }
+    UnlockControlState(UnlockControlState&& state) = default;
 
     bool unlocked = false;
     unsigned int mode = 0;
     String pin = "not set";
 
     UnlockControlState& operator=(const UnlockControlState& state);
-    bool operator==(const UnlockControlState& state);
-    bool operator!=(const UnlockControlState& state);
+    UnlockControlState& operator=(UnlockControlState&& state) = default;
+    bool operator==(const UnlockControlState& state) const;
+    bool operator!=(const UnlockControlState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1612,8 +2776,8 @@ public:
     void setButtonVisibility(bool up, bool right, bool down, bool left, bool mid);
 
     NavigatorState& operator=(const NavigatorState& state);
-    bool operator==(const NavigatorState& state);
-    bool operator!=(const NavigatorState& state);
+    bool operator==(const NavigatorState& state) const;
+    bool operator!=(const NavigatorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1635,6 +2799,7 @@ public:
         this->barName = bData.barName;
         this->barValue = bData.barValue;
     }
+    BarData(BarData&& bData) = default;
     BarData(const String& bar_name, float bar_value) {
         this->barName = bar_name;
         this->barValue = bar_value;
@@ -1655,6 +2820,7 @@ public:
         this->barValue = bData.barValue;
         return *this;
     }
+    BarData& operator=(BarData&& bData) = default;
 
     String toString(unsigned int barIndex){
         String bData;
@@ -1686,6 +2852,7 @@ public:
     BarGraphState(const BarGraphState& state){
         this->copy(state);
     }
+    BarGraphState(BarGraphState&& state) = default;
 
     void addBar(const BarData& bData){
         this->barDataList.AddItem(bData);
@@ -1705,9 +2872,9 @@ public:
     void changeBarDataAt(unsigned int index, const BarData& bd){
         this->barDataList.ReplaceAt(index, bd);
     }
-    BarData getBarDataAt(unsigned int index){
+    BarData getBarDataAt(unsigned int index) const {
         if(index < this->barDataList.GetCount()){
-            this->barDataList.GetAt(index);
+            return this->barDataList.GetAt(index);
         }
         return BarData();
     }
@@ -1717,9 +2884,10 @@ public:
     float fixedMaximumValue = 0;
 
     BarGraphState&  operator=(const BarGraphState& state);
+    BarGraphState&  operator=(BarGraphState&& state) = default;
 
-    bool operator==(const BarGraphState& state);
-    bool operator!=(const BarGraphState& state);
+    bool operator==(const BarGraphState& state) const;
+    bool operator!=(const BarGraphState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1742,6 +2910,7 @@ public:
     LineGraphDataPoints(const LineGraphDataPoints& dataPoints){
         this->points = dataPoints.points;
     }
+    LineGraphDataPoints(LineGraphDataPoints&& dataPoints) = default;
     void addPoint(const POINT &p){
         this->points.AddItem(p);
     }
@@ -1752,13 +2921,14 @@ public:
         this->points = dataPoints.points;
         return *this;
     }
+    LineGraphDataPoints& operator=(LineGraphDataPoints&& dataPoints) = default;
     String toString();
 
-    unsigned int count(){
+    unsigned int count() const {
         return this->points.GetCount();
     }
 
-    bool operator==(const LineGraphDataPoints& lgdp){
+    bool operator==(const LineGraphDataPoints& lgdp) const {
         if(this->points.GetCount() == lgdp.points.GetCount()){
             for(unsigned int i = 0; i < this->points.GetCount(); i++){
                 if(this->points.GetAt(i) != lgdp.points.GetAt(i)){
@@ -1770,7 +2940,7 @@ public:
         return false;
     }
 
-    bool operator!=(const LineGraphDataPoints& lgdp){
+    bool operator!=(const LineGraphDataPoints& lgdp) const {
         return (*this == lgdp) ? false : true;
     }
 
@@ -1790,6 +2960,7 @@ public:
     LineGraphState(const LineGraphState& state){
         this->copy(state);
     }
+    LineGraphState(LineGraphState&& state) = default;
 
     bool drawGridLines = false;
     bool drawAxisValues = false;
@@ -1803,9 +2974,10 @@ public:
     LineGraphDataPoints lineGraphPoints;
 
     LineGraphState& operator=(const LineGraphState& state);
+    LineGraphState& operator=(LineGraphState&& state) = default;
 
-    bool operator==(const LineGraphState& state);
-    bool operator!=(const LineGraphState& state);
+    bool operator==(const LineGraphState& state) const;
+    bool operator!=(const LineGraphState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1828,6 +3000,7 @@ public:
     StringInterrogatorState(const StringInterrogatorState& state){
         this->copy(state);
     }
+    StringInterrogatorState(StringInterrogatorState&& state) = default;
     bool fieldOneVisible = true;
     bool fieldTwoVisible = true;
     StringInterrogatorFieldInputType fieldOneInputType = StringInterrogatorFieldInputType::SI_INPUT_TEXT;
@@ -1845,9 +3018,10 @@ public:
     String fieldTwoContent;
 
     StringInterrogatorState& operator=(const StringInterrogatorState& state);
+    StringInterrogatorState& operator=(StringInterrogatorState&& state) = default;
 
-    bool operator==(const StringInterrogatorState& state);
-    bool operator!=(const StringInterrogatorState& state);
+    bool operator==(const StringInterrogatorState& state) const;
+    bool operator!=(const StringInterrogatorState& state) const;
 
 private:
     cID associatedPropertyID = 0;
@@ -1873,8 +3047,8 @@ public:
 
     TextListPresenterState& operator=(const TextListPresenterState& state);
 
-    bool operator==(const TextListPresenterState& state);
-    bool operator!=(const TextListPresenterState& state);
+    bool operator==(const TextListPresenterState& state) const;
+    bool operator!=(const TextListPresenterState& state) const;
 
 private:
     cID associatedPropertyID = 0;
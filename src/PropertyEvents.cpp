@@ -0,0 +1,273 @@
+#include "LaRoomyApi_STM32.h"
+
+/*
+    Event queue mode
+
+    The property executions are parsed and applied to the property states in the transmission processing, the callback is invoked later
+    when the application dispatches the queued events. The state is buffered in compact form and rebuilt on dispatch, the fields which are
+    not part of the execution (e.g. the range of an extended level selector) are taken from the current property state.
+*/
+
+void LaRoomyAppImplementation::enableEventQueueMode(bool enable){
+    if(!enable && this->eventQueueMode){
+        this->dispatchPropertyEvents();
+    }
+    this->eventQueueMode = enable;
+}
+
+void LaRoomyAppImplementation::setEventCoalescing(PropertyType type, bool enable){
+    if(enable){
+        this->eventCoalescingMask |= (1UL << type);
+    }
+    else {
+        this->eventCoalescingMask &= ~(1UL << type);
+    }
+}
+
+bool LaRoomyAppImplementation::queuePropertyEvent(const DeviceProperty* property, const uint8_t* data, uint8_t size, uint8_t trackingType){
+    if(!this->eventQueueMode){
+        // the caller invokes the callback immediately
+        return false;
+    }
+    if(size > STATE_BINARY_MAX_SIZE){
+        size = STATE_BINARY_MAX_SIZE;
+    }
+    auto propertyID = property->propertyID;
+    auto type = property->propertyType;
+
+    if(this->eventCoalescingMask & (1UL << type)){
+        // only the latest queued event of the property can be replaced, otherwise the order of the events would change
+        for(int i = (int)this->propertyEventQueue.getCount() - 1; i >= 0; i--){
+            auto queuedEvent = this->propertyEventQueue.peekAt(i);
+
+            if(queuedEvent->propertyID == propertyID){
+                if((queuedEvent->propertyType == type)
+                    && ((type != PropertyType::EX_LEVEL_SELECTOR)
+                        || ((queuedEvent->trackingType == ExLevelTrackingType::INTERTRACK) && (trackingType == ExLevelTrackingType::INTERTRACK))))
+                {
+                    queuedEvent->size = size;
+                    memcpy(queuedEvent->data, data, size);
+                    this->coalescedEventCount++;
+                    return true;
+                }
+                break;
+            }
+        }
+    }
+
+    PROPERTYEVENT event;
+    event.propertyID = propertyID;
+    event.handler = property->handler;
+    event.handlerContext = property->handlerContext;
+    event.propertyType = (uint8_t)type;
+    event.trackingType = trackingType;
+    event.size = size;
+    if(size > 0){
+        memcpy(event.data, data, size);
+    }
+
+    if(!this->propertyEventQueue.push(event)){
+        this->droppedEventCount++;
+
+        if(this->is_monitor_enabled){
+            Serial.println("WARNING - property event queue full, event discarded.");
+        }
+    }
+    return true;
+}
+
+unsigned int LaRoomyAppImplementation::dispatchPropertyEvents(unsigned int maxEvents){
+    PROPERTYEVENT event;
+    unsigned int count = 0;
+
+    while(((maxEvents == 0) || (count < maxEvents)) && this->propertyEventQueue.pop(event)){
+        count++;
+
+        if((event.handler == nullptr) && (this->pLrCallback == nullptr)){
+            continue;
+        }
+        // rebuild the state and pass it with the handler of the reception time
+        switch(event.propertyType){
+            case PropertyType::BUTTON:
+                this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, nullptr);
+                break;
+            case PropertyType::SWITCH:
+            case PropertyType::LEVEL_SELECTOR:
+            case PropertyType::OPTION_SELECTOR:
+                this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, event.data);
+                break;
+            case PropertyType::RGB_SELECTOR:
+                {
+                    RGBSelectorState s(this->getRGBSelectorState(event.propertyID));
+                    s.fromBinary(event.data, event.size);
+                    s.associatedPropertyID = event.propertyID;
+                    this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, &s);
+                }
+                break;
+            case PropertyType::EX_LEVEL_SELECTOR:
+                {
+                    ExtendedLevelSelectorState s(this->getExtendedLevelSelectorState(event.propertyID));
+                    s.fromBinary(event.data, event.size);
+                    s.trackingType = (ExLevelTrackingType)event.trackingType;
+                    s.associatedPropertyID = event.propertyID;
+                    this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, &s);
+                }
+                break;
+            case PropertyType::TIME_SELECTOR:
+                {
+                    TimeSelectorState s;
+                    s.fromBinary(event.data, event.size);
+                    s.associatedPropertyID = event.propertyID;
+                    this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, &s);
+                }
+                break;
+            case PropertyType::TIME_FRAME_SELECTOR:
+                {
+                    TimeFrameSelectorState s;
+                    s.fromBinary(event.data, event.size);
+                    s.associatedPropertyID = event.propertyID;
+                    this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, &s);
+                }
+                break;
+            case PropertyType::DATE_SELECTOR:
+                {
+                    DateSelectorState s;
+                    s.fromBinary(event.data, event.size);
+                    s.associatedPropertyID = event.propertyID;
+                    this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, &s);
+                }
+                break;
+            case PropertyType::NAVIGATOR:
+                {
+                    NavigatorState s;
+                    s.buttonType = event.data[0];
+                    s.actionType = event.data[1];
+                    s.associatedPropertyID = event.propertyID;
+                    this->deliverPropertyEvent(event.propertyID, event.propertyType, event.handler, event.handlerContext, &s);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return count;
+}
+
+void LaRoomyAppImplementation::deliverPropertyEvent(const DeviceProperty* property, void* state){
+    this->deliverPropertyEvent(property->propertyID, property->propertyType, property->handler, property->handlerContext, state);
+}
+
+void LaRoomyAppImplementation::deliverPropertyEvent(cID propertyID, unsigned int propertyType, PropertyHandler handler, void* context, void* state){
+    // the property handler replaces the callback interface
+    auto callback = this->pLrCallback;
+
+    if((handler == nullptr) && (callback == nullptr)){
+        return;
+    }
+    switch(propertyType){
+        case PropertyType::BUTTON:
+            if(handler != nullptr){
+                reinterpret_cast<ButtonHandler>(handler)(propertyID, context);
+            }
+            else {
+                callback->onButtonPressed(propertyID);
+            }
+            break;
+        case PropertyType::SWITCH:
+            {
+                auto newState = (*reinterpret_cast<uint8_t*>(state) != 0) ? true : false;
+                if(handler != nullptr){
+                    reinterpret_cast<SwitchHandler>(handler)(propertyID, newState, context);
+                }
+                else {
+                    callback->onSwitchStateChanged(propertyID, newState);
+                }
+            }
+            break;
+        case PropertyType::LEVEL_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<SelectorValueHandler>(handler)(propertyID, *reinterpret_cast<uint8_t*>(state), context);
+            }
+            else {
+                callback->onLevelSelectorValueChanged(propertyID, *reinterpret_cast<uint8_t*>(state));
+            }
+            break;
+        case PropertyType::OPTION_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<SelectorValueHandler>(handler)(propertyID, *reinterpret_cast<uint8_t*>(state), context);
+            }
+            else {
+                callback->onOptionSelectorIndexChanged(propertyID, *reinterpret_cast<uint8_t*>(state));
+            }
+            break;
+        case PropertyType::RGB_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<RGBSelectorHandler>(handler)(propertyID, *reinterpret_cast<RGBSelectorState*>(state), context);
+            }
+            else {
+                callback->onRGBSelectorStateChanged(propertyID, *reinterpret_cast<RGBSelectorState*>(state));
+            }
+            break;
+        case PropertyType::EX_LEVEL_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<ExtendedLevelSelectorHandler>(handler)(propertyID, *reinterpret_cast<ExtendedLevelSelectorState*>(state), context);
+            }
+            else {
+                callback->onExtendedLevelSelectorStateChanged(propertyID, *reinterpret_cast<ExtendedLevelSelectorState*>(state));
+            }
+            break;
+        case PropertyType::TIME_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<TimeSelectorHandler>(handler)(propertyID, *reinterpret_cast<TimeSelectorState*>(state), context);
+            }
+            else {
+                callback->onTimeSelectorStateChanged(propertyID, *reinterpret_cast<TimeSelectorState*>(state));
+            }
+            break;
+        case PropertyType::TIME_FRAME_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<TimeFrameSelectorHandler>(handler)(propertyID, *reinterpret_cast<TimeFrameSelectorState*>(state), context);
+            }
+            else {
+                callback->onTimeFrameSelectorStateChanged(propertyID, *reinterpret_cast<TimeFrameSelectorState*>(state));
+            }
+            break;
+        case PropertyType::DATE_SELECTOR:
+            if(handler != nullptr){
+                reinterpret_cast<DateSelectorHandler>(handler)(propertyID, *reinterpret_cast<DateSelectorState*>(state), context);
+            }
+            else {
+                callback->onDateSelectorStateChanged(propertyID, *reinterpret_cast<DateSelectorState*>(state));
+            }
+            break;
+        case PropertyType::UNLOCK_CONTROL:
+            if(handler != nullptr){
+                reinterpret_cast<UnlockControlHandler>(handler)(propertyID, *reinterpret_cast<UnlockControlState*>(state), context);
+            }
+            else {
+                callback->onUnlockControlStateChanged(propertyID, *reinterpret_cast<UnlockControlState*>(state));
+            }
+            break;
+        case PropertyType::NAVIGATOR:
+            if(handler != nullptr){
+                reinterpret_cast<NavigatorHandler>(handler)(propertyID, *reinterpret_cast<NavigatorState*>(state), context);
+            }
+            else {
+                callback->onNavigatorStateChanged(propertyID, *reinterpret_cast<NavigatorState*>(state));
+            }
+            break;
+        case PropertyType::STRING_INTERROGATOR:
+            {
+                auto s = reinterpret_cast<StringInterrogatorState*>(state);
+                if(handler != nullptr){
+                    reinterpret_cast<StringInterrogatorHandler>(handler)(propertyID, s->fieldOneContent, s->fieldTwoContent, context);
+                }
+                else {
+                    callback->onStringInterrogatorDataReceived(propertyID, s->fieldOneContent, s->fieldTwoContent);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
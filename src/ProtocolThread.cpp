@@ -0,0 +1,189 @@
+#include "LaRoomyApi_STM32.h"
+
+/*
+    Protocol thread
+
+    In thread mode the protocol thread is the only context which calls the bluetooth stack: it polls the stack (which invokes the
+    connection and reception handler) and sends the queued transmissions. The application thread processes the received transmissions
+    and the events in onLoop() and queues the outgoing data, so it never waits for radio I/O.
+*/
+
+// set to wake the protocol thread before the poll interval has elapsed (data queued or thread stop requested)
+#define PROTOCOL_THREAD_FLAG_WAKEUP     0x01
+
+#ifdef LAROOMY_STATIC_ALLOCATION
+alignas(rtos::Thread) static uint8_t protocolThreadStorage[sizeof(rtos::Thread)];
+alignas(8) static unsigned char protocolThreadStack[LAROOMY_PROTOCOL_THREAD_STACK_SIZE];
+#endif
+
+bool LaRoomyAppImplementation::startProtocolThread(osPriority priority, uint32_t stackSize){
+    if(this->protocolThreadRunning){
+        return true;
+    }
+#ifdef LAROOMY_STATIC_ALLOCATION
+    this->pProtocolThread =
+        new (protocolThreadStorage) rtos::Thread(priority, sizeof(protocolThreadStack), protocolThreadStack, "LaRoomy");
+#else
+    this->pProtocolThread = new rtos::Thread(priority, stackSize, nullptr, "LaRoomy");
+    if(this->pProtocolThread == nullptr){
+        return false;
+    }
+#endif
+    this->protocolThreadRunning = true;
+
+    if(this->pProtocolThread->start(mbed::callback(this, &LaRoomyAppImplementation::protocolThreadFunction)) != osOK){
+        this->protocolThreadRunning = false;
+        this->releaseProtocolThread();
+
+        if(this->is_monitor_enabled){
+            Serial.println("ERROR: The protocol thread could not be started.");
+        }
+        return false;
+    }
+    return true;
+}
+
+void LaRoomyAppImplementation::stopProtocolThread(){
+    if(this->pProtocolThread == nullptr){
+        return;
+    }
+    this->protocolThreadRunning = false;
+    this->protocolThreadFlags.set(PROTOCOL_THREAD_FLAG_WAKEUP);
+    this->pProtocolThread->join();
+    this->releaseProtocolThread();
+
+    // data queued for the thread is discarded, the pending events are handled in the next onLoop()
+    this->queueMutex.lock();
+    this->txQueue.reset();
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::releaseProtocolThread(){
+#ifdef LAROOMY_STATIC_ALLOCATION
+    this->pProtocolThread->~Thread();
+#else
+    delete this->pProtocolThread;
+#endif
+    this->pProtocolThread = nullptr;
+}
+
+void LaRoomyAppImplementation::protocolThreadFunction(){
+    while(this->protocolThreadRunning){
+        // the lifecycle steps are executed here, so that the stack is not accessed from two threads
+        this->ble_processLifecycle();
+        if(this->ble_isActive()){
+            BLE.poll();
+        }
+        this->transmitQueuedData();
+
+        // sleep until the poll interval has elapsed or data is queued for transmission (at least one millisecond, the thread must not spin)
+        this->protocolThreadFlags.wait_any_for(
+            PROTOCOL_THREAD_FLAG_WAKEUP,
+            std::chrono::milliseconds((this->protocolPollInterval > 0) ? this->protocolPollInterval : 1)
+        );
+    }
+}
+
+bool LaRoomyAppImplementation::reserveTransmissionSlots(unsigned int count){
+    if(!this->protocolThreadRunning){
+        return true;
+    }
+    // only the application thread adds data, so the free space can not decrease until the slots are filled
+    this->queueMutex.lock();
+    auto available = (this->txQueue.getFreeCount() >= count);
+    this->queueMutex.unlock();
+
+    if(!available){
+        this->txQueueOverflowCount++;
+
+        if(this->is_monitor_enabled){
+            Serial.println("WARNING - transmission queue full, data discarded.");
+        }
+    }
+    return available;
+}
+
+bool LaRoomyAppImplementation::transmit(const char* data){
+    if(!this->protocolThreadRunning){
+        this->pTxCharacteristic->writeValue(data);
+        return true;
+    }
+    TRANSMISSIONSLOT slot;
+    strncpy(slot.data, data, OUT_MTU_SIZE);
+    slot.data[OUT_MTU_SIZE] = '\0';
+
+    this->queueMutex.lock();
+    auto queued = this->txQueue.push(slot);
+    this->queueMutex.unlock();
+
+    if(queued){
+        this->protocolThreadFlags.set(PROTOCOL_THREAD_FLAG_WAKEUP);
+    }
+    else {
+        this->txQueueOverflowCount++;
+
+        if(this->is_monitor_enabled){
+            Serial.println("WARNING - transmission queue full, data discarded.");
+        }
+    }
+    return queued;
+}
+
+void LaRoomyAppImplementation::transmitQueuedData(){
+    TRANSMISSIONSLOT slot;
+
+    while(true){
+        // the radio I/O happens outside the lock, so the application thread is never blocked by it
+        this->queueMutex.lock();
+        auto available = this->txQueue.pop(slot);
+        this->queueMutex.unlock();
+
+        if(!available){
+            break;
+        }
+        if(this->is_connected && (this->pTxCharacteristic != nullptr)){
+            this->pTxCharacteristic->writeValue(slot.data);
+        }
+    }
+}
+
+bool LaRoomyAppImplementation::receiveTransmission(){
+    this->queueMutex.lock();
+    auto available = this->tmc.pop(this->rxData);
+    this->queueMutex.unlock();
+
+    return available;
+}
+
+void LaRoomyAppImplementation::postProtocolEvent(const PROTOCOLEVENT& event){
+    this->queueMutex.lock();
+    auto queued = this->eventQueue.push(event);
+    this->queueMutex.unlock();
+
+    if(!queued && this->is_monitor_enabled){
+        Serial.println("WARNING - event queue full, event discarded.");
+    }
+}
+
+void LaRoomyAppImplementation::dispatchProtocolEvents(){
+    PROTOCOLEVENT event;
+
+    while(true){
+        this->queueMutex.lock();
+        auto available = this->eventQueue.pop(event);
+        this->queueMutex.unlock();
+
+        if(!available){
+            break;
+        }
+        switch(event.type){
+            case ProtocolEventType::CONNECTION_STATE_CHANGED:
+                if(this->pLrCallback != nullptr){
+                    this->pLrCallback->onConnectionStateChanged(event.value != 0);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,127 @@
+#include "RGBOutput.h"
+
+void PWMOutput::begin(){
+    pinMode(this->redPin, OUTPUT);
+    pinMode(this->greenPin, OUTPUT);
+    pinMode(this->bluePin, OUTPUT);
+    this->write(0, 0, 0);
+}
+
+void PWMOutput::end(){
+    this->write(0, 0, 0);
+}
+
+void PWMOutput::write(uint8_t red, uint8_t green, uint8_t blue){
+    analogWrite(this->redPin, red);
+    analogWrite(this->greenPin, green);
+    analogWrite(this->bluePin, blue);
+}
+
+LEDStripOutput::LEDStripOutput(mbed::SPI* spi, uint8_t* frameBuffer, unsigned int pixelCount, LEDStripType stripType)
+    : spi(spi), frameBuffer(frameBuffer), pixelCount(pixelCount)
+{
+    this->channelCount = (stripType == LED_STRIP_SK6812_RGBW) ? 4 : 3;
+    this->frameLength = LED_STRIP_FRAME_BUFFER_SIZE(pixelCount, stripType);
+}
+
+void LEDStripOutput::begin(){
+    if(this->spi != nullptr){
+        this->spi->format(8, 0);
+        this->spi->frequency(LED_STRIP_SPI_FREQUENCY);
+    }
+    // the reset bytes are never overwritten by the rendering
+    memset(this->frameBuffer, 0, this->frameLength);
+
+    this->hasFrame = false;
+    this->write(0, 0, 0);
+}
+
+void LEDStripOutput::end(){
+    this->write(0, 0, 0);
+}
+
+void LEDStripOutput::write(uint8_t red, uint8_t green, uint8_t blue){
+    // the frame is only rendered if the color changes (a pending frame is replaced in any case)
+    if(this->hasFrame && !this->framePending && (red == this->currentColor[0]) && (green == this->currentColor[1]) && (blue == this->currentColor[2])){
+        return;
+    }
+    // the frame buffer must not be changed while it is transferred
+    if(this->transferActive){
+        this->pendingColor[0] = red;
+        this->pendingColor[1] = green;
+        this->pendingColor[2] = blue;
+        this->framePending = true;
+        return;
+    }
+    this->framePending = false;
+    this->render(red, green, blue);
+    this->transmit();
+}
+
+bool LEDStripOutput::update(){
+    // send the color which was set during the transfer
+    if(this->framePending && !this->transferActive){
+        this->framePending = false;
+        this->render(this->pendingColor[0], this->pendingColor[1], this->pendingColor[2]);
+        this->transmit();
+    }
+    return this->framePending;
+}
+
+void LEDStripOutput::render(uint8_t red, uint8_t green, uint8_t blue){
+    this->currentColor[0] = red;
+    this->currentColor[1] = green;
+    this->currentColor[2] = blue;
+    this->hasFrame = true;
+
+    // the strip expects the green channel first, the white channel of a RGBW strip takes the common part of the color
+    uint8_t channels[4] = { green, red, blue, 0 };
+    if(this->channelCount == 4){
+        uint8_t white = (red < green) ? red : green;
+        if(blue < white){
+            white = blue;
+        }
+        channels[0] -= white;
+        channels[1] -= white;
+        channels[2] -= white;
+        channels[3] = white;
+    }
+
+    // encode one pixel: each data bit is sent as three SPI bits, '1' -> 110, '0' -> 100 (MSB first)
+    auto pixel = this->frameBuffer;
+    for(unsigned int c = 0; c < this->channelCount; c++){
+        uint32_t bits = 0;
+        for(int b = 7; b >= 0; b--){
+            bits = (bits << 3) | ((channels[c] & (1 << b)) ? 0x6 : 0x4);
+        }
+        pixel[c * 3] = (uint8_t)(bits >> 16);
+        pixel[c * 3 + 1] = (uint8_t)(bits >> 8);
+        pixel[c * 3 + 2] = (uint8_t)bits;
+    }
+
+    // all pixels have the same color, so the first pixel is copied
+    unsigned int pixelSize = this->channelCount * LED_STRIP_BYTES_PER_CHANNEL;
+    for(unsigned int i = 1; i < this->pixelCount; i++){
+        memcpy(&this->frameBuffer[i * pixelSize], pixel, pixelSize);
+    }
+    this->frameCount++;
+}
+
+void LEDStripOutput::transmit(){
+    if(this->spi == nullptr){
+        return;
+    }
+#if DEVICE_SPI_ASYNCH
+    this->transferActive = true;
+    this->spi->transfer(this->frameBuffer, (int)this->frameLength, (uint8_t*)nullptr, 0,
+        mbed::callback(this, &LEDStripOutput::onTransferComplete), SPI_EVENT_COMPLETE);
+#else
+    this->spi->write((const char*)this->frameBuffer, (int)this->frameLength, nullptr, 0);
+#endif
+}
+
+void LEDStripOutput::onTransferComplete(int event){
+    (void)event;
+    // interrupt context: a pending frame is rendered and sent by update()
+    this->transferActive = false;
+}
@@ -0,0 +1,191 @@
+#ifndef RGB_OUTPUT_H
+#define RGB_OUTPUT_H
+
+#include <Arduino.h>
+#include <mbed.h>
+
+#include "constDef.h"
+
+// the SPI clock of the addressable strip output, each data bit of the strip is encoded in three SPI bits (1.25us per data bit)
+#define LED_STRIP_SPI_FREQUENCY     2400000
+
+// the number of SPI bytes per color channel
+#define LED_STRIP_BYTES_PER_CHANNEL 3
+
+// zero bytes at the end of the frame, the low level latches the data (> 280us at the SPI clock)
+#define LED_STRIP_RESET_BYTES       90
+
+// the size in bytes of the frame buffer for an addressable strip
+#define LED_STRIP_FRAME_BUFFER_SIZE(pixelCount, stripType) \
+    ((pixelCount) * (((stripType) == LED_STRIP_SK6812_RGBW) ? 4 : 3) * LED_STRIP_BYTES_PER_CHANNEL + LED_STRIP_RESET_BYTES)
+
+/**
+ * @brief Output backend of RGBControl. The control computes the color values (fading, programs, gamma correction) and passes them to the backend.
+ * NOTE: In timer driven fading mode (see RGBControl::enableTimerDrivenFading(...)) write(...) is called from interrupt context,
+ *       the mode is only available if the backend reports isInterruptSafe().
+ * 
+ */
+class RGBOutput {
+public:
+    virtual ~RGBOutput() {}
+
+    // prepare the output, called by RGBControl::begin()
+    virtual void begin() = 0;
+
+    // release the output, the output is dark afterwards
+    virtual void end() = 0;
+
+    /**
+     * @brief Set the output color
+     * 
+     * @param red The red value
+     * @param green The green value
+     * @param blue The blue value
+     */
+    virtual void write(uint8_t red, uint8_t green, uint8_t blue) = 0;
+
+    // check if write(...) may be called from interrupt context (non-blocking, no allocation)
+    virtual bool isInterruptSafe() const {
+        return true;
+    }
+
+    /**
+     * @brief Complete deferred output work in thread context, called by RGBControl::onLoop()
+     * 
+     * @return true if work is still pending, onLoop() is called again shortly
+     */
+    virtual bool update(){
+        return false;
+    }
+};
+
+/**
+ * @brief Output on three PWM pins (analogWrite)
+ * 
+ */
+class PWMOutput : public RGBOutput {
+public:
+    PWMOutput(pin_size_t RedPin, pin_size_t GreenPin, pin_size_t BluePin)
+        : redPin(RedPin), greenPin(GreenPin), bluePin(BluePin) {}
+
+    void begin() override;
+    void end() override;
+    void write(uint8_t red, uint8_t green, uint8_t blue) override;
+
+private:
+    pin_size_t redPin;
+    pin_size_t greenPin;
+    pin_size_t bluePin;
+};
+
+/**
+ * @brief Output on an addressable strip (WS2812 / SK6812), all pixels show the color. The frame is rendered into the frame buffer as SPI bit stream
+ * and sent via SPI (only MOSI is connected to the data input of the strip). If the target supports asynchronous SPI, the frame is sent by DMA,
+ * a color change during the transfer is rendered and sent by update() when the transfer is complete.
+ * The rendering and the blocking SPI write are not interrupt-safe, so the timer driven fading of RGBControl is not available with this output.
+ * NOTE: The frame buffer is provided by the caller, so no memory is allocated. Example:
+ *       static uint8_t frame[LED_STRIP_FRAME_BUFFER_SIZE(60, LED_STRIP_WS2812)];
+ *       LEDStripOutput strip(&spi, frame, 60);
+ * 
+ */
+class LEDStripOutput : public RGBOutput {
+public:
+    /**
+     * @brief Construct a new LEDStripOutput object
+     * 
+     * @param spi The SPI bus, nullptr renders the frames without output (e.g. to measure the rendering throughput)
+     * @param frameBuffer The buffer of LED_STRIP_FRAME_BUFFER_SIZE(pixelCount, stripType) bytes, must remain valid while the object exists
+     * @param pixelCount The number of pixels of the strip
+     * @param stripType Type: LEDStripType Enum - defines the channel order and count
+     */
+    LEDStripOutput(mbed::SPI* spi, uint8_t* frameBuffer, unsigned int pixelCount, LEDStripType stripType = LED_STRIP_WS2812);
+
+    void begin() override;
+    void end() override;
+    void write(uint8_t red, uint8_t green, uint8_t blue) override;
+    bool update() override;
+
+    bool isInterruptSafe() const override {
+        return false;
+    }
+
+    // the number of rendered frames
+    unsigned long getFrameCount() const {
+        return this->frameCount;
+    }
+
+    // the length of the frame in bytes (including the reset bytes)
+    unsigned int getFrameLength() const {
+        return this->frameLength;
+    }
+
+    const uint8_t* getFrameBuffer() const {
+        return this->frameBuffer;
+    }
+
+private:
+    mbed::SPI* spi;
+    uint8_t* frameBuffer;
+    unsigned int pixelCount;
+    unsigned int channelCount;
+    unsigned int frameLength;
+
+    uint8_t currentColor[3] = { 0, 0, 0 };
+    bool hasFrame = false;
+    unsigned long frameCount = 0;
+
+    // a color change during the transfer, the completion interrupt only clears 'transferActive'
+    volatile bool transferActive = false;
+    bool framePending = false;
+    uint8_t pendingColor[3] = { 0, 0, 0 };
+
+    void render(uint8_t red, uint8_t green, uint8_t blue);
+    void transmit();
+    void onTransferComplete(int event);
+};
+
+/**
+ * @brief Output without hardware, records the written values (e.g. to test the fading and the timing on the host)
+ * 
+ */
+class MockOutput : public RGBOutput {
+public:
+    void begin() override {
+        this->begun = true;
+    }
+
+    void end() override {
+        this->write(0, 0, 0);
+        this->begun = false;
+    }
+
+    void write(uint8_t red, uint8_t green, uint8_t blue) override {
+        this->red = red;
+        this->green = green;
+        this->blue = blue;
+        this->writeCount++;
+    }
+
+    bool isBegun() const {
+        return this->begun;
+    }
+
+    unsigned long getWriteCount() const {
+        return this->writeCount;
+    }
+
+    void resetWriteCount(){
+        this->writeCount = 0;
+    }
+
+    // the last written values
+    uint8_t red = 0;
+    uint8_t green = 0;
+    uint8_t blue = 0;
+
+private:
+    bool begun = false;
+    unsigned long writeCount = 0;
+};
+
+#endif // RGB_OUTPUT_H
@@ -0,0 +1,28 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// SHA-256 (FIPS 180-4) of the pin storage. The implementation does not depend on the Arduino core, so it can be checked on the host
+// against the test vectors (see extras/test/Sha256Test.cpp).
+
+#define SHA256_HASH_SIZE    32
+
+typedef struct _SHA256CONTEXT {
+    uint32_t state[8];
+    uint8_t block[64];
+    uint32_t blockLength;
+    uint64_t totalLength;
+} Sha256Context;
+
+// start a new hash
+void sha256Init(Sha256Context* ctx);
+
+// add the data to the hash (can be called several times)
+void sha256Update(Sha256Context* ctx, const uint8_t* data, size_t length);
+
+// complete the hash and write the SHA256_HASH_SIZE bytes to hash_out
+void sha256Final(Sha256Context* ctx, uint8_t* hash_out);
+
+#endif // SHA256_H
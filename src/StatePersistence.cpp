@@ -0,0 +1,275 @@
+#include "LaRoomyApi_STM32.h"
+
+/*
+    Property state snapshot
+
+    All persisted states are stored in one value, so the whole state store is written with one flash write and restored with one read.
+
+    Layout:
+        [0] 'L'  [1] 'S'  [2] format version  [3] number of entries
+        for each entry:
+            [0..1] property ID (little endian)  [2] property type  [3] data size  [4..] state data (see toBinary(...) of the state classes)
+*/
+
+#define STATE_SNAPSHOT_KEY  FSTORAGE_KEY("lr_states")
+
+#define STATE_SNAPSHOT_VERSION          1
+#define STATE_SNAPSHOT_HEADER_SIZE      4
+#define STATE_SNAPSHOT_ENTRY_HEADER_SIZE    4
+
+// FNV-1a hash of the snapshot, used to skip writes of unchanged content
+static uint32_t snapshotChecksum(const uint8_t* data, unsigned int size){
+    uint32_t hash = 2166136261UL;
+    for(unsigned int i = 0; i < size; i++){
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+void LaRoomyAppImplementation::enableStatePersistence(bool enable, unsigned long debounceTime){
+    this->statePersistenceEnabled = enable;
+    this->stateSnapshotDebounceTime = debounceTime;
+
+    if(!enable){
+        this->stateSnapshotPending = false;
+        this->scheduler.suspendTask(this->snapshotTask);
+    }
+}
+
+bool LaRoomyAppImplementation::restorePropertyStates(){
+    uint8_t buffer[LAROOMY_STATE_SNAPSHOT_SIZE];
+    size_t size = 0;
+
+    if(!FlashStorageManager.readData(STATE_SNAPSHOT_KEY, buffer, sizeof(buffer), &size)){
+        return false;
+    }
+    if((size < STATE_SNAPSHOT_HEADER_SIZE) || (buffer[0] != 'L') || (buffer[1] != 'S') || (buffer[2] != STATE_SNAPSHOT_VERSION)){
+        if(this->is_monitor_enabled){
+            Serial.println("WARNING: The stored state snapshot is invalid and was ignored.");
+        }
+        return false;
+    }
+    this->applyStateSnapshot(buffer, size);
+    this->lastSnapshotChecksum = snapshotChecksum(buffer, size);
+
+    if(this->is_monitor_enabled){
+        Serial.print("Property states restored (");
+        Serial.print(buffer[3]);
+        Serial.println(" entries)");
+    }
+    return true;
+}
+
+bool LaRoomyAppImplementation::saveStateSnapshot(){
+    this->stateSnapshotPending = false;
+
+    uint8_t buffer[LAROOMY_STATE_SNAPSHOT_SIZE];
+    auto size = this->createStateSnapshot(buffer, sizeof(buffer));
+    auto checksum = snapshotChecksum(buffer, size);
+
+    // nothing to do if the content equals the last written (or restored) snapshot
+    if(checksum == this->lastSnapshotChecksum){
+        return true;
+    }
+    if(FlashStorageManager.writeData(STATE_SNAPSHOT_KEY, buffer, size)){
+        this->lastSnapshotChecksum = checksum;
+
+        if(this->is_monitor_enabled){
+            Serial.print("State snapshot written (");
+            Serial.print(size);
+            Serial.println(" bytes)");
+        }
+        return true;
+    }
+    else {
+        // retry after the next debounce period
+        if(this->statePersistenceEnabled){
+            this->stateSnapshotPending = true;
+            this->scheduler.scheduleTask(this->snapshotTask, this->stateSnapshotDebounceTime);
+        }
+        if(this->is_monitor_enabled){
+            Serial.println("ERROR: The state snapshot could not be written.");
+        }
+        return false;
+    }
+}
+
+void LaRoomyAppImplementation::onPropertyStateChanged(cID propertyID, bool synchronized){
+    this->trackStateChange(propertyID, synchronized);
+
+    // the debounce time starts with the first change, subsequent changes are included in the same write
+    if(this->statePersistenceEnabled && !this->stateSnapshotPending){
+        this->stateSnapshotPending = true;
+        this->scheduler.scheduleTask(this->snapshotTask, this->stateSnapshotDebounceTime);
+    }
+}
+
+unsigned int LaRoomyAppImplementation::createStateSnapshot(uint8_t* buffer, unsigned int size){
+    unsigned int pos = STATE_SNAPSHOT_HEADER_SIZE;
+    uint8_t count = 0;
+
+    for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
+        auto p = this->deviceProperties.getObjectCoreReferenceAt(i);
+
+        uint8_t data[STATE_BINARY_MAX_SIZE];
+        uint8_t dataSize = 0;
+
+        switch(p->propertyType){
+            case PropertyType::SWITCH:
+            case PropertyType::LEVEL_SELECTOR:
+            case PropertyType::LEVEL_INDICATOR:
+            case PropertyType::OPTION_SELECTOR:
+                data[0] = (uint8_t)p->propertyState;
+                dataSize = 1;
+                break;
+            case PropertyType::RGB_SELECTOR:
+                {
+                    auto s = findStoredState(this->rgbStates, p->propertyID);
+                    if(s != nullptr){
+                        dataSize = s->toBinary(data);
+                    }
+                }
+                break;
+            case PropertyType::EX_LEVEL_SELECTOR:
+                {
+                    auto s = findStoredState(this->extendedLevelStates, p->propertyID);
+                    if(s != nullptr){
+                        dataSize = s->toBinary(data);
+                    }
+                }
+                break;
+            case PropertyType::TIME_SELECTOR:
+                {
+                    auto s = findStoredState(this->timeSelectorStates, p->propertyID);
+                    if(s != nullptr){
+                        dataSize = s->toBinary(data);
+                    }
+                }
+                break;
+            case PropertyType::TIME_FRAME_SELECTOR:
+                {
+                    auto s = findStoredState(this->timeFrameSelectorStates, p->propertyID);
+                    if(s != nullptr){
+                        dataSize = s->toBinary(data);
+                    }
+                }
+                break;
+            case PropertyType::DATE_SELECTOR:
+                {
+                    auto s = findStoredState(this->dateSelectorStates, p->propertyID);
+                    if(s != nullptr){
+                        dataSize = s->toBinary(data);
+                    }
+                }
+                break;
+            default:
+                // the other types have no persistent state
+                break;
+        }
+        if((dataSize == 0) || (p->propertyID > 0xFFFF)){
+            continue;
+        }
+        if(((pos + STATE_SNAPSHOT_ENTRY_HEADER_SIZE + dataSize) > size) || (count == 255)){
+            if(this->is_monitor_enabled){
+                Serial.println("WARNING: The state snapshot buffer is exhausted (see LAROOMY_STATE_SNAPSHOT_SIZE).");
+            }
+            break;
+        }
+        buffer[pos] = (uint8_t)(p->propertyID & 0xFF);
+        buffer[pos + 1] = (uint8_t)((p->propertyID >> 8) & 0xFF);
+        buffer[pos + 2] = (uint8_t)p->propertyType;
+        buffer[pos + 3] = dataSize;
+        memcpy(buffer + pos + STATE_SNAPSHOT_ENTRY_HEADER_SIZE, data, dataSize);
+
+        pos += (STATE_SNAPSHOT_ENTRY_HEADER_SIZE + dataSize);
+        count++;
+    }
+
+    buffer[0] = 'L';
+    buffer[1] = 'S';
+    buffer[2] = STATE_SNAPSHOT_VERSION;
+    buffer[3] = count;
+
+    return pos;
+}
+
+void LaRoomyAppImplementation::applyStateSnapshot(const uint8_t* data, unsigned int size){
+    unsigned int pos = STATE_SNAPSHOT_HEADER_SIZE;
+
+    for(uint8_t n = 0; n < data[3]; n++){
+        if((pos + STATE_SNAPSHOT_ENTRY_HEADER_SIZE) > size){
+            break;
+        }
+        cID propertyID = data[pos] | (data[pos + 1] << 8);
+        uint8_t propertyType = data[pos + 2];
+        uint8_t dataSize = data[pos + 3];
+        const uint8_t* stateData = data + pos + STATE_SNAPSHOT_ENTRY_HEADER_SIZE;
+
+        pos += (STATE_SNAPSHOT_ENTRY_HEADER_SIZE + dataSize);
+        if(pos > size){
+            break;
+        }
+
+        // the property must still exist with the same type
+        auto index = this->propertyIndexFromPropertyID(propertyID);
+        if((index == INVALID_ELEMENT_INDEX) || (dataSize == 0)){
+            continue;
+        }
+        auto p = this->deviceProperties.getObjectCoreReferenceAt(index);
+        if(p->propertyType != propertyType){
+            continue;
+        }
+
+        switch(propertyType){
+            case PropertyType::SWITCH:
+            case PropertyType::LEVEL_SELECTOR:
+            case PropertyType::LEVEL_INDICATOR:
+            case PropertyType::OPTION_SELECTOR:
+                p->propertyState = stateData[0];
+                break;
+            case PropertyType::RGB_SELECTOR:
+                {
+                    auto s = findStoredState(this->rgbStates, propertyID);
+                    if(s != nullptr){
+                        s->fromBinary(stateData, dataSize);
+                    }
+                }
+                break;
+            case PropertyType::EX_LEVEL_SELECTOR:
+                {
+                    auto s = findStoredState(this->extendedLevelStates, propertyID);
+                    if(s != nullptr){
+                        s->fromBinary(stateData, dataSize);
+                    }
+                }
+                break;
+            case PropertyType::TIME_SELECTOR:
+                {
+                    auto s = findStoredState(this->timeSelectorStates, propertyID);
+                    if(s != nullptr){
+                        s->fromBinary(stateData, dataSize);
+                    }
+                }
+                break;
+            case PropertyType::TIME_FRAME_SELECTOR:
+                {
+                    auto s = findStoredState(this->timeFrameSelectorStates, propertyID);
+                    if(s != nullptr){
+                        s->fromBinary(stateData, dataSize);
+                    }
+                }
+                break;
+            case PropertyType::DATE_SELECTOR:
+                {
+                    auto s = findStoredState(this->dateSelectorStates, propertyID);
+                    if(s != nullptr){
+                        s->fromBinary(stateData, dataSize);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,177 @@
+#include "LaRoomyApi_STM32.h"
+
+/*
+    State resume
+
+    Every state change increments the state sequence number and stores it in the property element (changeSequence). When the state
+    is transmitted to the app, or was changed by the app, while the app is connected and has loaded the properties, the number is also
+    stored as synchronized (syncedSequence). The disconnection resets the loading flag, so nothing sent before the app reports the
+    restored connection (notification '7') counts as received. On this notification only the states with a change newer than the
+    synchronized one are sent as update transmissions, and only the states which were really sent are marked as synchronized.
+    The sequence numbers are only valid as long as the app holds the property structure of the device, so every structure change which
+    is not transmitted to the app (because it is disconnected) invalidates the resume until the properties are loaded again.
+    In protocol thread mode a state counts as sent when it is queued, so the disconnection invalidates the resume as well if queued
+    transmissions are discarded.
+*/
+
+void LaRoomyAppImplementation::enableStateResume(bool enable){
+    this->stateResumeEnabled = enable;
+    // the changes before this point are not tracked, so a full refresh is required until the next property loading
+    this->stateResumeValid = false;
+}
+
+void LaRoomyAppImplementation::trackStateChange(cID propertyID, bool synchronized){
+    if(!this->stateResumeEnabled){
+        return;
+    }
+    for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
+        if(this->deviceProperties.getObjectCoreReferenceAt(i)->propertyID == propertyID){
+            this->stateSequence++;
+            this->deviceProperties.getObjectCoreReferenceAt(i)->changeSequence = this->stateSequence;
+
+            if(synchronized){
+                this->markStateSynchronized(i);
+            }
+            break;
+        }
+    }
+}
+
+void LaRoomyAppImplementation::markStateSynchronized(unsigned int propertyIndex){
+    // the disconnect handler resets the flags under the same lock (from the protocol thread in threaded mode)
+    this->queueMutex.lock();
+    if(this->stateResumeEnabled && this->is_connected && this->propertyLoadingDone && (propertyIndex < this->deviceProperties.GetCount())){
+        auto p = this->deviceProperties.getObjectCoreReferenceAt(propertyIndex);
+        p->syncedSequence = p->changeSequence;
+    }
+    this->queueMutex.unlock();
+}
+
+void LaRoomyAppImplementation::onPropertyStructureChanged(){
+    // if connected, the change is transmitted to the app
+    if(!this->is_connected){
+        this->stateResumeValid = false;
+    }
+}
+
+bool LaRoomyAppImplementation::resumeChangedStates(){
+    if(!this->stateResumeValid || !this->propertyLoadingDone){
+        return false;
+    }
+    unsigned int count = 0;
+
+    for(unsigned int i = 0; i < this->deviceProperties.GetCount(); i++){
+        auto p = this->deviceProperties.getObjectCoreReferenceAt(i);
+
+        // a state which could not be sent remains unsynchronized and is sent on the next resume (or requested by the app)
+        if(p->changeSequence != p->syncedSequence){
+            if(this->sendStateUpdate(i)){
+                this->markStateSynchronized(i);
+                count++;
+            }
+        }
+    }
+    this->lastResumedStateCount = count;
+
+    if(this->is_monitor_enabled){
+        Serial.print("State resume: ");
+        Serial.print(count);
+        Serial.println(" state(s) sent");
+    }
+    return true;
+}
+
+bool LaRoomyAppImplementation::sendStateUpdate(unsigned int propertyIndex){
+    auto p = this->deviceProperties.getObjectCoreReferenceAt(propertyIndex);
+
+    switch(p->propertyType){
+        case PropertyType::SWITCH:
+        case PropertyType::LEVEL_SELECTOR:
+        case PropertyType::LEVEL_INDICATOR:
+        case PropertyType::OPTION_SELECTOR:
+            return this->sendSimpleStateUpdate(propertyIndex, p->propertyState);
+        case PropertyType::RGB_SELECTOR:
+            {
+                auto s = findStoredState(this->rgbStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::EX_LEVEL_SELECTOR:
+            {
+                auto s = findStoredState(this->extendedLevelStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::TIME_SELECTOR:
+            {
+                auto s = findStoredState(this->timeSelectorStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::TIME_FRAME_SELECTOR:
+            {
+                auto s = findStoredState(this->timeFrameSelectorStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::DATE_SELECTOR:
+            {
+                auto s = findStoredState(this->dateSelectorStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::UNLOCK_CONTROL:
+            {
+                auto s = findStoredState(this->unlockControlStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::NAVIGATOR:
+            {
+                auto s = findStoredState(this->navigatorStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::BAR_GRAPH:
+            {
+                auto s = findStoredState(this->barGraphStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::LINE_GRAPH:
+            {
+                auto s = findStoredState(this->lineGraphStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        case PropertyType::STRING_INTERROGATOR:
+            {
+                auto s = findStoredState(this->stringInterrogatorStates, p->propertyID);
+                if(s != nullptr){
+                    return this->sendData(s->toStateString(propertyIndex, TransmissionSubType::UPDATE));
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    return false;
+}
@@ -0,0 +1,150 @@
+#ifndef LR_STRING_ARENA_H
+#define LR_STRING_ARENA_H
+
+#include <Arduino.h>
+#include "memoryConfig.h"
+
+/**
+ * @brief Bump allocator for strings which live as long as the property set (e.g. the property and group descriptors).
+ * The strings are stored zero-terminated in one contiguous buffer, so the returned pointers can be used directly as views.
+ * Single strings cannot be released, the whole arena is reset at once.
+ */
+class StringArena {
+public:
+    /**
+     * @brief Copy a string into the arena.
+     *
+     * @param str The string to store
+     * @param length The length of the string (without terminator)
+     * @return const char* - the view to the stored string or nullptr if the arena capacity is exhausted
+     */
+    const char* store(const char* str, unsigned int length){
+        if((this->used + length + 1) > LAROOMY_STRING_ARENA_SIZE){
+            this->rejectedCount++;
+            return nullptr;
+        }
+        char* ref = &this->buffer[this->used];
+        for(unsigned int i = 0; i < length; i++){
+            ref[i] = str[i];
+        }
+        ref[length] = '\0';
+
+        this->used += (length + 1);
+        this->storedCount++;
+        // the memory a separate heap block would have occupied for this string
+        this->heapEquivalent += (length + 1 + LAROOMY_HEAP_BLOCK_OVERHEAD);
+        return ref;
+    }
+
+    /**
+     * @brief Overwrite a string in the arena. This is only possible if the new string is not longer than the stored one.
+     *
+     * @param ref The view to the stored string (must be obtained from this arena)
+     * @param str The new string
+     * @param length The length of the new string (without terminator)
+     * @return true if the string was replaced
+     */
+    bool replace(const char* ref, const char* str, unsigned int length){
+        if(!this->contains(ref) || length > strlen(ref)){
+            return false;
+        }
+        char* target = &this->buffer[ref - this->buffer];
+        for(unsigned int i = 0; i < length; i++){
+            target[i] = str[i];
+        }
+        target[length] = '\0';
+        return true;
+    }
+
+    // check if the pointer refers to a string in this arena
+    bool contains(const char* ref) const {
+        return (ref >= this->buffer) && (ref < (this->buffer + this->used));
+    }
+
+    // release all strings at once - all views become invalid
+    void reset(){
+        this->used = 0;
+        this->storedCount = 0;
+        this->rejectedCount = 0;
+        this->heapEquivalent = 0;
+    }
+
+    // the number of occupied bytes
+    unsigned int getUsedBytes() const {
+        return this->used;
+    }
+
+    // the size of the arena buffer
+    unsigned int getCapacity() const {
+        return LAROOMY_STRING_ARENA_SIZE;
+    }
+
+    // the number of strings in the arena
+    unsigned int getStoredCount() const {
+        return this->storedCount;
+    }
+
+    // the number of strings which did not fit and remained on the heap
+    unsigned int getRejectedCount() const {
+        return this->rejectedCount;
+    }
+
+    // the heap memory (including the block overhead) the stored strings would occupy as separate String objects
+    unsigned int getHeapEquivalent() const {
+        return this->heapEquivalent;
+    }
+
+    /**
+     * @brief Move a string into the arena (see arenaStringData(...)). On success the view is set and the heap memory of the string is released,
+     * otherwise the string remains unchanged.
+     *
+     * @param str The string to move
+     * @param arenaRef The view of the object to set
+     * @param previousRef The previous view of the object, its slot is reused if the new string is not longer (optional)
+     * @return true if the string was moved into the arena
+     */
+    bool bind(String& str, const char*& arenaRef, const char* previousRef = nullptr){
+        if(str.length() == 0){
+            return false;
+        }
+        const char* ref = nullptr;
+        if((previousRef != nullptr) && this->replace(previousRef, str.c_str(), str.length())){
+            ref = previousRef;
+        }
+        else {
+            ref = this->store(str.c_str(), str.length());
+        }
+        if(ref == nullptr){
+            return false;
+        }
+        arenaRef = ref;
+        str = String();
+        return true;
+    }
+
+private:
+    char buffer[LAROOMY_STRING_ARENA_SIZE];
+    unsigned int used = 0;
+    unsigned int storedCount = 0;
+    unsigned int rejectedCount = 0;
+    unsigned int heapEquivalent = 0;
+};
+
+// An object with an arena string holds a String and a view to the arena, the view is only valid while the String is empty.
+
+// get the effective string of the pair (the string or the arena view)
+inline const char* arenaStringData(const String& str, const char* arenaRef){
+    return ((str.length() == 0) && (arenaRef != nullptr)) ? arenaRef : str.c_str();
+}
+
+// copy the arena view back to the string (the object is no longer bound to the arena)
+inline void materializeArenaString(String& str, const char*& arenaRef){
+    if(arenaRef != nullptr){
+        if(str.length() == 0){
+            str = arenaRef;
+        }
+        arenaRef = nullptr;
+    }
+}
+
+#endif // LR_STRING_ARENA_H
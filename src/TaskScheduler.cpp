@@ -0,0 +1,129 @@
+#include "TaskScheduler.h"
+
+int TaskScheduler::addTask(TaskFunction function, void* context, unsigned long interval, unsigned long firstDelay){
+    if(function == nullptr){
+        return INVALID_TASK_HANDLE;
+    }
+    for(int i = 0; i < LAROOMY_MAX_SCHEDULED_TASKS; i++){
+        if(!this->tasks[i].used){
+            this->tasks[i] = {};
+            this->tasks[i].function = function;
+            this->tasks[i].context = context;
+            this->tasks[i].interval = interval;
+            this->tasks[i].used = true;
+            this->scheduleTask(i, firstDelay);
+            return i;
+        }
+    }
+    return INVALID_TASK_HANDLE;
+}
+
+void TaskScheduler::removeTask(int handle){
+    if(this->isValidHandle(handle)){
+        this->tasks[handle].used = false;
+        this->tasks[handle].scheduled = false;
+    }
+}
+
+void TaskScheduler::scheduleTask(int handle, unsigned long delay){
+    if(this->isValidHandle(handle)){
+        if(delay == SCHEDULER_NO_DEADLINE){
+            this->tasks[handle].scheduled = false;
+        }
+        else {
+            this->tasks[handle].deadline = millis() + delay;
+            this->tasks[handle].scheduled = true;
+        }
+    }
+}
+
+void TaskScheduler::setTaskInterval(int handle, unsigned long interval){
+    if(this->isValidHandle(handle)){
+        this->tasks[handle].interval = interval;
+    }
+}
+
+bool TaskScheduler::isTaskScheduled(int handle){
+    return (this->isValidHandle(handle) && this->tasks[handle].scheduled) ? true : false;
+}
+
+unsigned long TaskScheduler::run(){
+    auto now = millis();
+
+    for(int i = 0; i < LAROOMY_MAX_SCHEDULED_TASKS; i++){
+        auto task = &this->tasks[i];
+
+        // the signed difference keeps the comparison valid over the millis() overflow
+        if(!task->used || !task->scheduled || ((long)(now - task->deadline) < 0)){
+            continue;
+        }
+        auto lateness = now - task->deadline;
+
+        task->statistics.runCount++;
+        task->statistics.totalLateness += lateness;
+        if(lateness > task->statistics.maxLateness){
+            task->statistics.maxLateness = lateness;
+        }
+
+        // the next deadline is set before the execution, so the task can override it
+        if(task->interval > 0){
+            task->deadline += task->interval;
+            if((long)(now - task->deadline) >= 0){
+                // missed periods are skipped instead of executed in a burst
+                task->deadline = now + task->interval;
+            }
+        }
+        else {
+            task->scheduled = false;
+        }
+
+        auto start = micros();
+        task->function(task->context);
+        auto executionTime = micros() - start;
+
+        if(task->used && (executionTime > task->statistics.maxExecutionTime)){
+            task->statistics.maxExecutionTime = executionTime;
+        }
+    }
+
+    // get the time until the next deadline
+    now = millis();
+    unsigned long next = SCHEDULER_NO_DEADLINE;
+
+    for(int i = 0; i < LAROOMY_MAX_SCHEDULED_TASKS; i++){
+        if(this->tasks[i].used && this->tasks[i].scheduled){
+            unsigned long remaining =
+                ((long)(this->tasks[i].deadline - now) > 0) ? (this->tasks[i].deadline - now) : 0;
+
+            if(remaining < next){
+                next = remaining;
+            }
+        }
+    }
+    return next;
+}
+
+bool TaskScheduler::getTaskStatistics(int handle, TASKSTATISTICS& statistics){
+    if(this->isValidHandle(handle)){
+        statistics = this->tasks[handle].statistics;
+        return true;
+    }
+    return false;
+}
+
+unsigned long TaskScheduler::getMaxLateness(){
+    unsigned long maxLateness = 0;
+
+    for(int i = 0; i < LAROOMY_MAX_SCHEDULED_TASKS; i++){
+        if(this->tasks[i].used && (this->tasks[i].statistics.maxLateness > maxLateness)){
+            maxLateness = this->tasks[i].statistics.maxLateness;
+        }
+    }
+    return maxLateness;
+}
+
+void TaskScheduler::resetStatistics(){
+    for(int i = 0; i < LAROOMY_MAX_SCHEDULED_TASKS; i++){
+        this->tasks[i].statistics = {};
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include "memoryConfig.h"
+
+// the deadline value of a task which is not scheduled (also returned by TaskScheduler::run() if no task is scheduled)
+#define SCHEDULER_NO_DEADLINE   0xFFFFFFFFUL
+
+// returned by TaskScheduler::addTask(...) if no task slot is available
+#define INVALID_TASK_HANDLE     -1
+
+/**
+ * @brief The function of a scheduled task
+ *
+ * @param context The context pointer passed to TaskScheduler::addTask(...)
+ */
+typedef void (*TaskFunction)(void* context);
+
+/**
+ * @brief Timing statistics of a scheduled task. The lateness is the time between the deadline and the actual execution,
+ * so it reflects the jitter caused by the loop and by other tasks.
+ */
+typedef struct _TASKSTATISTICS {
+    unsigned long runCount;
+    unsigned long maxLateness;          // milliseconds
+    unsigned long totalLateness;        // milliseconds (divide by runCount for the average)
+    unsigned long maxExecutionTime;     // microseconds
+} TASKSTATISTICS, *PTASKSTATISTICS;
+
+/**
+ * @brief Cooperative scheduler for the periodic and deferred work of the library and the application.
+ * Each task has a deadline, TaskScheduler::run() executes only the tasks which are due and returns the time until the next deadline,
+ * so the caller can sleep (or do other work) in the meantime. Tasks are never preempted, a long running task delays the other tasks.
+ * The task slots are fixed (LAROOMY_MAX_SCHEDULED_TASKS), no memory is allocated.
+ */
+class TaskScheduler {
+public:
+    /**
+     * @brief Add a task
+     *
+     * @param function The function to execute
+     * @param context The pointer passed to the function
+     * @param interval The period in milliseconds, 0 makes a one-shot task which is suspended after the execution
+     * @param firstDelay The time in milliseconds until the first execution, SCHEDULER_NO_DEADLINE adds the task suspended
+     * @return int - the task handle or INVALID_TASK_HANDLE if all slots are occupied
+     */
+    int addTask(TaskFunction function, void* context, unsigned long interval, unsigned long firstDelay = 0);
+
+    /**
+     * @brief Remove a task, the slot is free for reuse. A task may remove itself during its execution.
+     *
+     * @param handle The handle returned by addTask(...)
+     */
+    void removeTask(int handle);
+
+    /**
+     * @brief Set the deadline of a task relative to the current time. The interval of the task is not changed.
+     * NOTE: If called from within the task function, this overrides the deadline computed from the interval.
+     *
+     * @param handle The handle of the task
+     * @param delay The time in milliseconds until the execution, SCHEDULER_NO_DEADLINE suspends the task
+     */
+    void scheduleTask(int handle, unsigned long delay);
+
+    /**
+     * @brief Suspend a task until it is scheduled again
+     */
+    void suspendTask(int handle){
+        this->scheduleTask(handle, SCHEDULER_NO_DEADLINE);
+    }
+
+    /**
+     * @brief Change the period of a task, takes effect after the next execution
+     */
+    void setTaskInterval(int handle, unsigned long interval);
+
+    // check if the task has a deadline
+    bool isTaskScheduled(int handle);
+
+    /**
+     * @brief Execute all tasks which are due. Must be called from the main loop (LaRoomyApi.onLoop() does this for the library scheduler).
+     *
+     * @return unsigned long - the time in milliseconds until the next deadline, or SCHEDULER_NO_DEADLINE if no task is scheduled
+     */
+    unsigned long run();
+
+    /**
+     * @brief Get the timing statistics of a task
+     *
+     * @param handle The handle of the task
+     * @param statistics The structure to fill
+     * @return true if the handle is valid
+     */
+    bool getTaskStatistics(int handle, TASKSTATISTICS& statistics);
+
+    // the maximum lateness of all tasks in milliseconds
+    unsigned long getMaxLateness();
+
+    // reset the statistics of all tasks
+    void resetStatistics();
+
+private:
+    typedef struct _SCHEDULEDTASK {
+        TaskFunction function;
+        void* context;
+        unsigned long interval;
+        unsigned long deadline;
+        bool used;
+        bool scheduled;
+        TASKSTATISTICS statistics;
+    } SCHEDULEDTASK;
+
+    SCHEDULEDTASK tasks[LAROOMY_MAX_SCHEDULED_TASKS] = {};
+
+    bool isValidHandle(int handle){
+        return ((handle >= 0) && (handle < LAROOMY_MAX_SCHEDULED_TASKS) && this->tasks[handle].used) ? true : false;
+    }
+};
+
+#endif // TASK_SCHEDULER_H
@@ -1,11 +1,25 @@
 #include "UnlockControlPinStorageController.h"
 #include "flashStorageManager.h"
+#include "Sha256.h"
 
 #define DATA_KEY_UNLOCK_CONTROL_PIN "uc_pin_dkey"
 #define DATA_KEY_UNLOCK_PIN_VALID   "vldd_uc_pin_r"
 
+// the pin and the valid-flag are stored in one record, the single pin key is only read to migrate data from older versions
+#define DATA_KEY_UNLOCK_PIN_RECORD  "uc_pin_rcrd"
+#define RECORD_VALUE_PIN            "pin"
+
+// the hashed pin of an unlock-control property is stored under this key, combined with the property ID
+#define DATA_KEY_UNLOCK_CONTROL_PIN_HASH    FSTORAGE_KEY("uc_pin_hash")
+
+#define PIN_HASH_FORMAT_VERSION 1
+#define PIN_HASH_SIZE           SHA256_HASH_SIZE
+
 bool UnlockControlPinStorageController::unlockControlPinStorageControllerInstanceCreated = false;
 UnlockControlPinStorageController* UnlockControlPinStorageController::ucpInstance = nullptr;
+#ifdef LAROOMY_STATIC_ALLOCATION
+alignas(UnlockControlPinStorageController) uint8_t UnlockControlPinStorageController::instanceStorage[sizeof(UnlockControlPinStorageController)];
+#endif
 
 UnlockControlPinStorageController::UnlockControlPinStorageController()
 {}
@@ -23,7 +37,11 @@ UnlockControlPinStorageController* UnlockControlPinStorageController::GetInstanc
     }
     else
     {
+#ifdef LAROOMY_STATIC_ALLOCATION
+        ucpInstance = new (instanceStorage) UnlockControlPinStorageController();
+#else
         ucpInstance = new UnlockControlPinStorageController();
+#endif
         if(ucpInstance != nullptr)
         {
             unlockControlPinStorageControllerInstanceCreated = true;
@@ -37,10 +55,27 @@ String UnlockControlPinStorageController::loadPin(){
     String pin("12345");
 
     // load data
-    auto temp_pin = FlashStorageManager.readString(DATA_KEY_UNLOCK_CONTROL_PIN);
-    if(temp_pin.length() > 0)
+    FStorageRecord record;
+    if(FlashStorageManager.readRecord(DATA_KEY_UNLOCK_PIN_RECORD, record))
+    {
+        // the pin is only used if the write was complete
+        if(record.readUInt(DATA_KEY_UNLOCK_PIN_VALID) != 0)
+        {
+            auto temp_pin = record.readString(RECORD_VALUE_PIN);
+            if(temp_pin.length() > 0)
+            {
+                pin = temp_pin;
+            }
+        }
+    }
+    else
     {
-        pin = temp_pin;
+        // no record, look for a pin in the previous format
+        auto temp_pin = FlashStorageManager.readString(DATA_KEY_UNLOCK_CONTROL_PIN);
+        if(temp_pin.length() > 0)
+        {
+            pin = temp_pin;
+        }
     }
     return pin;
 }
@@ -50,8 +85,122 @@ bool UnlockControlPinStorageController::savePin(const String& pin){
     // validate pin length
     if(pin.length() > 0 && pin.length() < 11){
 
-        // save
-        return FlashStorageManager.writeString(DATA_KEY_UNLOCK_CONTROL_PIN, pin);
+        // save the pin together with the valid-flag in one flash write
+        FStorageRecord record;
+        if(!record.writeString(RECORD_VALUE_PIN, pin) || !record.writeUInt(DATA_KEY_UNLOCK_PIN_VALID, 1))
+        {
+            // an incomplete record is not written
+            return false;
+        }
+
+        if(FlashStorageManager.writeRecord(DATA_KEY_UNLOCK_PIN_RECORD, record))
+        {
+            // the pin in the previous format is superseded
+            FlashStorageManager.eraseData(DATA_KEY_UNLOCK_CONTROL_PIN);
+            return true;
+        }
+        return false;
     }
     return false;
-}
\ No newline at end of file
+}
+
+bool UnlockControlPinStorageController::savePin(unsigned int unlockControlID, const char* pin)
+{
+    auto length = strlen(pin);
+
+    // validate pin length
+    if((length == 0) || (length > UNLOCK_CONTROL_PIN_MAX_LENGTH))
+    {
+        return false;
+    }
+
+    uint8_t data[PIN_HASH_SIZE + 1];
+    data[0] = PIN_HASH_FORMAT_VERSION;
+    this->hashPin(unlockControlID, pin, length, data + 1);
+
+    return FlashStorageManager.writeData(
+        DATA_KEY_UNLOCK_CONTROL_PIN_HASH.withIndex(unlockControlID),
+        data,
+        sizeof(data)
+    );
+}
+
+bool UnlockControlPinStorageController::verifyPin(unsigned int unlockControlID, const char* pin, size_t length)
+{
+    uint8_t stored[PIN_HASH_SIZE + 1];
+    uint8_t hash[PIN_HASH_SIZE];
+    size_t actual_size = 0;
+
+    // the pin is hashed in any case, so the duration does not reveal if the pin was saved
+    this->hashPin(unlockControlID, pin, (length > UNLOCK_CONTROL_PIN_MAX_LENGTH) ? UNLOCK_CONTROL_PIN_MAX_LENGTH : length, hash);
+
+    bool saved =
+        FlashStorageManager.readData(DATA_KEY_UNLOCK_CONTROL_PIN_HASH.withIndex(unlockControlID), stored, sizeof(stored), &actual_size)
+        && (actual_size == sizeof(stored))
+        && (stored[0] == PIN_HASH_FORMAT_VERSION);
+
+    if(!saved)
+    {
+        return comparePins(pin, length, UNLOCK_CONTROL_DEFAULT_PIN, strlen(UNLOCK_CONTROL_DEFAULT_PIN));
+    }
+
+    uint8_t diff = (length > UNLOCK_CONTROL_PIN_MAX_LENGTH) ? 1 : 0;
+    for(unsigned int i = 0; i < PIN_HASH_SIZE; i++)
+    {
+        diff |= (hash[i] ^ stored[i + 1]);
+    }
+    return (diff == 0) ? true : false;
+}
+
+bool UnlockControlPinStorageController::hasPin(unsigned int unlockControlID)
+{
+    uint8_t stored[PIN_HASH_SIZE + 1];
+    size_t actual_size = 0;
+
+    return FlashStorageManager.readData(DATA_KEY_UNLOCK_CONTROL_PIN_HASH.withIndex(unlockControlID), stored, sizeof(stored), &actual_size)
+        && (actual_size == sizeof(stored));
+}
+
+bool UnlockControlPinStorageController::removePin(unsigned int unlockControlID)
+{
+    return FlashStorageManager.eraseData(DATA_KEY_UNLOCK_CONTROL_PIN_HASH.withIndex(unlockControlID));
+}
+
+bool UnlockControlPinStorageController::comparePins(const char* pin, size_t length, const char* reference, size_t referenceLength)
+{
+    // always compare the maximum length, so the duration depends neither on the content nor on the position of a mismatch
+    uint8_t diff = (length != referenceLength) ? 1 : 0;
+
+    if((length > UNLOCK_CONTROL_PIN_MAX_LENGTH) || (referenceLength > UNLOCK_CONTROL_PIN_MAX_LENGTH))
+    {
+        diff = 1;
+        length = 0;
+        referenceLength = 0;
+    }
+
+    for(unsigned int i = 0; i < UNLOCK_CONTROL_PIN_MAX_LENGTH; i++)
+    {
+        uint8_t a = (i < length) ? (uint8_t)pin[i] : 0;
+        uint8_t b = (i < referenceLength) ? (uint8_t)reference[i] : 0;
+        diff |= (a ^ b);
+    }
+    return (diff == 0) ? true : false;
+}
+
+void UnlockControlPinStorageController::hashPin(unsigned int unlockControlID, const char* pin, size_t length, uint8_t* hash_out)
+{
+    // the property ID is part of the hash, so equal pins of different properties have different hashes
+    uint8_t id[4] = {
+        (uint8_t)unlockControlID,
+        (uint8_t)(unlockControlID >> 8),
+        (uint8_t)(unlockControlID >> 16),
+        (uint8_t)(unlockControlID >> 24)
+    };
+
+    Sha256Context ctx;
+    sha256Init(&ctx);
+    sha256Update(&ctx, (const uint8_t*)"LaRoomyPin", 10);
+    sha256Update(&ctx, id, sizeof(id));
+    sha256Update(&ctx, (const uint8_t*)pin, length);
+    sha256Final(&ctx, hash_out);
+}
@@ -2,6 +2,13 @@
 #define UNLOCKCONTROL_PIN_STORAGE_CONTROLLER_H
 
 #include <Arduino.h>
+#include "memoryConfig.h"
+
+// the maximum length of an unlock-control pin
+#define UNLOCK_CONTROL_PIN_MAX_LENGTH   10
+
+// the default pin of an unlock-control if no pin was saved
+#define UNLOCK_CONTROL_DEFAULT_PIN      "12345"
 
 class UnlockControlPinStorageController {
 public:
@@ -29,16 +36,59 @@ public:
      */
     bool savePin(const String& pin);
 
+    /**
+     * @brief Save the pin of a specific unlock-control property. The pin is not stored as plain text, only a SHA-256 hash
+     * of the pin and the property ID is stored, each unlock-control has its own storage key.
+     * 
+     * @param unlockControlID The ID of the unlock-control property
+     * @param pin The pin to save (1 to UNLOCK_CONTROL_PIN_MAX_LENGTH characters)
+     * @return bool - indicates if the operation succeeded or not
+     */
+    bool savePin(unsigned int unlockControlID, const char* pin);
+
+    /**
+     * @brief Verify a pin against the saved pin of the specified unlock-control property. If no pin was saved for the property,
+     * the pin is verified against the default pin UNLOCK_CONTROL_DEFAULT_PIN. The verification needs no heap memory and the
+     * comparison takes the same time regardless of the position of the first mismatch.
+     * 
+     * @param unlockControlID The ID of the unlock-control property
+     * @param pin The pin to verify (does not need to be terminated)
+     * @param length The length of the pin
+     * @return bool - true if the pin is valid
+     */
+    bool verifyPin(unsigned int unlockControlID, const char* pin, size_t length);
+
+    // check if a pin was saved for the specified unlock-control property
+    bool hasPin(unsigned int unlockControlID);
+
+    // erase the saved pin of the specified unlock-control property (the default pin is valid afterwards)
+    bool removePin(unsigned int unlockControlID);
+
+    /**
+     * @brief Compare two pins in constant time (the duration does not depend on the content). Pins longer than
+     * UNLOCK_CONTROL_PIN_MAX_LENGTH are never equal.
+     * 
+     * @return bool - true if the pins are equal
+     */
+    static bool comparePins(const char* pin, size_t length, const char* reference, size_t referenceLength);
+
 private:
     static bool unlockControlPinStorageControllerInstanceCreated;
     static UnlockControlPinStorageController* ucpInstance;
+#ifdef LAROOMY_STATIC_ALLOCATION
+    static uint8_t instanceStorage[];
+#endif
 
     UnlockControlPinStorageController();
+
+    // the hash which is stored for the pin of a property
+    void hashPin(unsigned int unlockControlID, const char* pin, size_t length, uint8_t* hash_out);
 };
 
 /**
  * @brief Access the Pin-Storage helper API. This class takes responibility for the flash storage of the pin.
- *          Please note that this is a singleton instance.
+ *          Please note that this is a singleton instance. loadPin() and savePin(pin) handle one global pin in plain text,
+ *          the methods with an unlock-control ID handle hashed pins for any number of unlock-control properties.
  * 
  */
 #define PinStorageController    (*UnlockControlPinStorageController::GetInstance())
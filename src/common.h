@@ -2,14 +2,20 @@
 #define LR_COMMON_H
 
 #include <Arduino.h>
+#include <mbed.h>
 
 #include "ItemCollection.h"
+#include "StringArena.h"
 #include "convert.h"
 #include "flashStorageManager.h"
+#include "AttemptThrottle.h"
+#include "TaskScheduler.h"
+#include "FixedQueue.h"
 
 #include <ArduinoBLE.h>
 
 #include "constDef.h"
+#include "RGBOutput.h"
 #include "imageID.h"
 #include "BindingController.h"
 #include "UnlockControlPinStorageController.h"
@@ -72,6 +72,33 @@ enum RGBTransitionType {
     HARD_TRANSITION
 };
 
+enum RGBFadeEasing {
+    FADE_LINEAR,
+    FADE_EASE_IN,
+    FADE_EASE_OUT,
+    FADE_EASE_IN_OUT
+};
+
+enum LEDStripType {
+    LED_STRIP_WS2812,           // GRB
+    LED_STRIP_SK6812_RGBW       // GRBW
+};
+
+enum BLELifecycleState {
+    BLE_STATE_STOPPED,
+    BLE_STATE_STOPPING,
+    BLE_STATE_STARTING,
+    BLE_STATE_ADVERTISING,
+    BLE_STATE_COUNT
+};
+
+enum BLEProfile {
+    BLE_PROFILE_BALANCED,
+    BLE_PROFILE_LOW_LATENCY,
+    BLE_PROFILE_POWER_SAVING,
+    BLE_PROFILE_COUNT
+};
+
 enum ExLevelSelectorFlags {
     HIDE_ON_OFF_SWITCH = 0x01,
     TRANSMIT_ONLY_START_END_TRACKING = 0x02
@@ -140,7 +167,8 @@ typedef enum {
     BINDING_AUTHENTICATION_FAIL_WRONG_KEY,
     BINDING_FAIL_NOT_IMPLEMENTED,
     BINDING_ERROR_UNKNOWN_REQUEST,
-    BINDING_ERROR_UNKNOWN
+    BINDING_ERROR_UNKNOWN,
+    BINDING_AUTHENTICATION_FAIL_THROTTLED
 }BindingResponseType;
 
 enum PropertyLoadingType {
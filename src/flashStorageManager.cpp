@@ -1,13 +1,44 @@
 #include "flashStorageManager.h"
+#include <mbed.h>
+
+// the key of the record which triggers the garbage collection in compact() (it is never written)
+#define FSTORAGE_COMPACTION_KEY "fs_compact"
+
+// compact() relies on the garbage collection of TDBStore::set_start() for a record which does not fit in the active area,
+// this is the behavior of Mbed OS 6 (used by the Arduino mbed core). With other versions compact() only updates the statistics.
+#if defined(MBED_MAJOR_VERSION) && (MBED_MAJOR_VERSION == 6)
+#define FSTORAGE_FORCED_GARBAGE_COLLECTION
+#endif
+
+// the master record TDBStore writes at the beginning of each area
+#define FSTORAGE_MASTER_RECORD_KEY_SIZE     4
+#define FSTORAGE_MASTER_RECORD_DATA_SIZE    8
 
 FStorage::FStorage(){
+    for(unsigned int i = 0; i < FSTORAGE_WRITE_CACHE_ENTRIES; i++)
+    {
+        this->pendingWrites[i].used = false;
+    }
+    for(unsigned int i = 0; i < FSTORAGE_READ_CACHE_ENTRIES; i++)
+    {
+        this->readCache[i].used = false;
+    }
+
     this->getFlashIAPLimits(&this->limits);
 
+#ifdef LAROOMY_STATIC_ALLOCATION
+    this->iapBlockDevice =
+        new (this->iapBlockDeviceStorage) FlashIAPBlockDevice(this->limits.start_address, this->limits.available_size);
+
+    this->tdbStore =
+        new (this->tdbStoreStorage) TDBStore(this->iapBlockDevice);
+#else
     this-> iapBlockDevice =
         new FlashIAPBlockDevice(this->limits.start_address, this->limits.available_size);
 
     this->tdbStore =
         new TDBStore(this->iapBlockDevice);
+#endif
 
     if(tdbStore != nullptr){
         auto result =
@@ -22,180 +53,853 @@ FStorage::FStorage(){
 
 FStorage::~FStorage()
 {
+    this->flush();
+
+#ifdef LAROOMY_STATIC_ALLOCATION
+    this->tdbStore->~TDBStore();
+    this->iapBlockDevice->~FlashIAPBlockDevice();
+#else
     delete this->tdbStore;
     delete this->iapBlockDevice;
+#endif
     flashStorageManagerInst = nullptr;
     flash_storage_manager_inst_exist = false;
 }
 
 FStorage* FStorage::flashStorageManagerInst = nullptr;
 bool FStorage::flash_storage_manager_inst_exist = false;
+#ifdef LAROOMY_STATIC_ALLOCATION
+alignas(FStorage) uint8_t FStorage::instanceStorage[sizeof(FStorage)];
+#endif
 
-bool FStorage::writeString(const String& key, const String& value)
+bool FStorage::writeString(const char* key, const char* value)
 {
-    auto bufferSize = value.length() + 1;
-    auto buffer = new uint8_t[bufferSize];
-    
-    int result =
-        (buffer != nullptr) ? MBED_SUCCESS : MBED_ERROR_ALLOC_FAILED;
+    // the value is stored including the terminator
+    return this->setValue(key, value, strlen(value) + 1);
+}
 
-    if(result == MBED_SUCCESS)
+bool FStorage::writeUInt(const char* key, unsigned int value)
+{
+    return this->setValue(key, &value, sizeof(unsigned int));
+}
+
+bool FStorage::writeInt(const char* key, int value)
+{
+    return this->setValue(key, &value, sizeof(int));
+}
+
+bool FStorage::writeData(const char* key, const void* data, size_t dataSize)
+{
+    return this->setValue(key, data, dataSize);
+}
+
+String FStorage::readString(const char* key)
+{
+    String value;
+
+    // read in chunks - values which fit into the buffer need only one lookup
+    char buffer[FSTORAGE_READ_BUFFER_SIZE];
+    size_t offset = 0;
+
+    while(true)
     {
-        for(unsigned int i = 0; i < value.length(); i++)
+        size_t actual_size = 0;
+
+        auto result =
+            this->lookupValue(key, buffer, sizeof(buffer), &actual_size, offset);
+
+        if(result != MBED_SUCCESS)
         {
-            buffer[i] = static_cast<uint8_t>(value.c_str()[i]);
+            break;
         }
-        buffer[value.length()] = 0;
-        
-        result =
-            this->tdbStore->set(
-                key.c_str(),
-                buffer,
-                bufferSize,
-                0
-            );
+        // the stored value includes the terminator
+        auto length = strnlen(buffer, actual_size);
+        value.concat(buffer, length);
 
-        delete[] buffer;
+        if((length < actual_size) || (actual_size < sizeof(buffer)))
+        {
+            break;
+        }
+        offset += actual_size;
     }
-    return result == MBED_SUCCESS ? true : false;
+    return value;
 }
 
-bool FStorage::writeUInt(const String& key, unsigned int value)
+unsigned int FStorage::readUInt(const char* key)
 {
+    unsigned int value = 0;
+    size_t actual_size = 0;
+
     auto result =
-        this->tdbStore->set(key.c_str(), &value, sizeof(unsigned int), 0);
-    
-    return (result == MBED_SUCCESS) ? true : false;
+        this->lookupValue(key, &value, sizeof(unsigned int), &actual_size);
+
+    if((result != MBED_SUCCESS) || (actual_size != sizeof(unsigned int)))
+    {
+        value = 0;
+    }
+    return value;
+}
+
+int FStorage::readInt(const char* key)
+{
+    int value = 0;
+    size_t actual_size = 0;
+
+    auto result =
+        this->lookupValue(key, &value, sizeof(int), &actual_size);
+
+    if((result != MBED_SUCCESS) || (actual_size != sizeof(int)))
+    {
+        value = 0;
+    }
+    return value;
 }
 
-bool FStorage::writeInt(const String& key, int value)
+bool FStorage::readData(const char* key, void* data_out)
 {
     auto result =
-        this->tdbStore->set(key.c_str(), &value, sizeof(int), 0);
-    
+        (data_out != nullptr)
+        ? MBED_SUCCESS : MBED_ERROR_INVALID_ARGUMENT;
+
+    if(result == MBED_SUCCESS)
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+        result =
+            this->findCachedValue(key, &data, &size);
+
+        if(result == MBED_SUCCESS)
+        {
+            memcpy(data_out, data, size);
+        }
+        else if(result == FSTORAGE_NOT_CACHED)
+        {
+            // the size of the output buffer is unknown, so the size must be read first
+            TDBStore::info_t info;
+
+            result =
+                this->tdbStore->get_info(key, &info);
+
+            if(result == MBED_SUCCESS)
+            {
+                size_t actual_size;
+
+                result =
+                    this->tdbStore->get(key, data_out, info.size, &actual_size);
+            }
+        }
+    }
     return (result == MBED_SUCCESS) ? true : false;
 }
 
-bool FStorage::writeData(const String& key, void* data, size_t dataSize)
+bool FStorage::readData(const char* key, void* data_out, size_t size, size_t* actual_size_out)
 {
     auto result =
-        this->tdbStore->set(key.c_str(), data, dataSize, 0);
-    
+        (data_out != nullptr)
+        ? MBED_SUCCESS : MBED_ERROR_INVALID_ARGUMENT;
+
+    size_t actual_size = 0;
+
+    if(result == MBED_SUCCESS)
+    {
+        result =
+            this->lookupValue(key, data_out, size, &actual_size);
+    }
+    if(actual_size_out != nullptr)
+    {
+        *actual_size_out = actual_size;
+    }
     return (result == MBED_SUCCESS) ? true : false;
 }
 
-String FStorage::readString(const String& key)
+bool FStorage::enableReadCache(bool enable)
 {
-    String value;
+    this->readCacheEnabled = enable;
+    this->readCacheComplete = false;
+
+    for(unsigned int i = 0; i < FSTORAGE_READ_CACHE_ENTRIES; i++)
+    {
+        this->readCache[i].used = false;
+    }
+
+    if(!enable)
+    {
+        return true;
+    }
+
+    // scan the store once and load all keys and values into the cache
+    KVStore::iterator_t it;
 
-    TDBStore::info_t info;
     auto result =
-        this->tdbStore->get_info(key.c_str(), &info);
+        this->tdbStore->iterator_open(&it);
+
+    if(result != MBED_SUCCESS)
+    {
+        return false;
+    }
+
+    char key[FSTORAGE_MAX_KEY_LENGTH + 1];
+    bool complete = true;
+    unsigned int index = 0;
 
-    if(result != MBED_ERROR_ITEM_NOT_FOUND)
+    while(true)
     {
-        auto buffer = new uint8_t[info.size];
-        if(buffer != nullptr)
+        result =
+            this->tdbStore->iterator_next(it, key, sizeof(key));
+
+        if(result == MBED_ERROR_ITEM_NOT_FOUND)
         {
-            size_t actual_size;
-            result = this->tdbStore->get(key.c_str(), buffer, info.size, &actual_size);
+            // end of the store
+            break;
+        }
+        if((result != MBED_SUCCESS) || (index >= FSTORAGE_READ_CACHE_ENTRIES))
+        {
+            // the key is too long or the cache is full
+            complete = false;
+            break;
+        }
 
-            if(result == MBED_SUCCESS)
+        size_t actual_size = 0;
+        result =
+            this->tdbStore->get(key, this->readCache[index].data, FSTORAGE_READ_CACHE_VALUE_SIZE, &actual_size);
+
+        TDBStore::info_t info;
+        if((result == MBED_SUCCESS) && (actual_size == FSTORAGE_READ_CACHE_VALUE_SIZE))
+        {
+            // the value may be truncated
+            if((this->tdbStore->get_info(key, &info) != MBED_SUCCESS) || (info.size > FSTORAGE_READ_CACHE_VALUE_SIZE))
             {
-                auto target = new char[info.size + 1];
-                if(target != nullptr)
-                {
-                    for(unsigned int i = 0; i < info.size; i++)
-                    {
-                        target[i] = static_cast<char>(buffer[i]);
-                    }
-                    target[info.size] = '\0';
-                    value = target;
-                    delete[] target;
-                }
+                result = MBED_ERROR_INVALID_SIZE;
             }
-            delete[] buffer;
+        }
+
+        if(result == MBED_SUCCESS)
+        {
+            strcpy(this->readCache[index].key, key);
+            this->readCache[index].size = actual_size;
+            this->readCache[index].used = true;
+            index++;
+        }
+        else
+        {
+            // the value does not fit
+            complete = false;
         }
     }
-    return value;
+    this->tdbStore->iterator_close(it);
+
+    // if all keys are in the cache, a key which is not found does not exist
+    this->readCacheComplete = complete;
+    return true;
 }
 
-unsigned int FStorage::readUInt(const String& key)
+bool FStorage::eraseData(const char* key)
 {
-    unsigned int value = 0;
+    return this->removeValue(key);
+}
+
+bool FStorage::writeRecord(const char* key, const FStorageRecord& record)
+{
+    return this->setValue(key, record.buffer, record.used);
+}
+
+bool FStorage::readRecord(const char* key, FStorageRecord& record_out)
+{
+    record_out.clear();
 
-    TDBStore::info_t info;
+    size_t actual_size = 0;
 
     auto result =
-        this->tdbStore->get_info(key.c_str(), &info);
+        this->lookupValue(key, record_out.buffer, FSTORAGE_RECORD_SIZE, &actual_size);
 
-    if(result != MBED_ERROR_ITEM_NOT_FOUND)
+    if(result == MBED_SUCCESS)
     {
-        size_t actual_size;
-        result =
-            this->tdbStore->get(key.c_str(), &value, sizeof(unsigned int), &actual_size);
+        record_out.used = actual_size;
+    }
+    return (result == MBED_SUCCESS) ? true : false;
+}
 
-        if(result != MBED_SUCCESS)
+void FStorage::enableWriteBehindCache(bool enable)
+{
+    if(!enable)
+    {
+        this->flush();
+    }
+    this->writeBehindEnabled = enable;
+}
+
+bool FStorage::flush()
+{
+    bool success = true;
+
+    auto index = this->findOldestPendingWrite();
+    while(index >= 0)
+    {
+        if(!this->commitPendingWrite(index))
         {
-            value = 0;
+            success = false;
         }
+        index = this->findOldestPendingWrite();
     }
-    return value;
+    return success;
 }
 
-int FStorage::readInt(const String& key)
+void FStorage::onLoop()
 {
-    int value = 0;
+    auto index = this->findOldestPendingWrite();
+    if(index >= 0)
+    {
+        this->commitPendingWrite(index);
+    }
+    else if(!this->usageInitialized || this->usageScanPending)
+    {
+        // the records are scanned when no write is pending, not in the write path
+        this->initializeUsage();
+    }
+}
 
-    TDBStore::info_t info;
+unsigned int FStorage::getPendingWriteCount()
+{
+    unsigned int count = 0;
+    for(unsigned int i = 0; i < FSTORAGE_WRITE_CACHE_ENTRIES; i++)
+    {
+        if(this->pendingWrites[i].used)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool FStorage::setValue(const char* key, const void* data, size_t size)
+{
+    if(this->writeBehindEnabled && this->stageWrite(key, data, size, false))
+    {
+        this->updateReadCache(key, data, size, false);
+        return true;
+    }
+    // the key or the value does not fit in the cache, so write directly - a pending write to the same key is superseded
+    auto index = this->findPendingWrite(key);
+    if(index >= 0)
+    {
+        this->pendingWrites[index].used = false;
+    }
 
     auto result =
-        this->tdbStore->get_info(key.c_str(), &info);
+        this->storeValue(key, data, size);
 
-    if(result != MBED_ERROR_ITEM_NOT_FOUND)
+    if(result == MBED_SUCCESS)
     {
-        size_t actual_size;
-        result =
-            this->tdbStore->get(key.c_str(), &value, sizeof(int), &actual_size);
+        this->updateReadCache(key, data, size, false);
+    }
+    else
+    {
+        this->invalidateReadCacheEntry(key);
+    }
+    return (result == MBED_SUCCESS) ? true : false;
+}
 
-        if(result != MBED_SUCCESS)
+bool FStorage::removeValue(const char* key)
+{
+    if(this->writeBehindEnabled && this->stageWrite(key, nullptr, 0, true))
+    {
+        this->updateReadCache(key, nullptr, 0, true);
+        return true;
+    }
+    auto index = this->findPendingWrite(key);
+    if(index >= 0)
+    {
+        this->pendingWrites[index].used = false;
+    }
+
+    auto result =
+        this->deleteValue(key);
+
+    if((result == MBED_SUCCESS) || (result == MBED_ERROR_ITEM_NOT_FOUND))
+    {
+        this->updateReadCache(key, nullptr, 0, true);
+    }
+    else
+    {
+        this->invalidateReadCacheEntry(key);
+    }
+    return (result == MBED_SUCCESS) ? true : false;
+}
+
+bool FStorage::stageWrite(const char* key, const void* data, size_t size, bool erase)
+{
+    if((strlen(key) > FSTORAGE_MAX_KEY_LENGTH) || (size > FSTORAGE_WRITE_CACHE_VALUE_SIZE))
+    {
+        return false;
+    }
+
+    // coalesce with a pending operation on the same key (the position in the commit order is kept)
+    auto index = this->findPendingWrite(key);
+    if(index < 0)
+    {
+        for(unsigned int i = 0; i < FSTORAGE_WRITE_CACHE_ENTRIES; i++)
+        {
+            if(!this->pendingWrites[i].used)
+            {
+                index = i;
+                break;
+            }
+        }
+        if(index < 0)
         {
-            value = 0;
+            // the cache is full, commit the oldest operation to make room
+            index = this->findOldestPendingWrite();
+            this->commitPendingWrite(index);
         }
+        strcpy(this->pendingWrites[index].key, key);
+        this->pendingWrites[index].sequence = this->writeSequence++;
+        this->pendingWrites[index].used = true;
     }
-    return value;
+
+    this->pendingWrites[index].erase = erase;
+    this->pendingWrites[index].size = size;
+    if(size > 0)
+    {
+        memcpy(this->pendingWrites[index].data, data, size);
+    }
+    return true;
+}
+
+int FStorage::findPendingWrite(const char* key)
+{
+    for(unsigned int i = 0; i < FSTORAGE_WRITE_CACHE_ENTRIES; i++)
+    {
+        if(this->pendingWrites[i].used && (strcmp(this->pendingWrites[i].key, key) == 0))
+        {
+            return i;
+        }
+    }
+    return -1;
 }
 
-bool FStorage::readData(const String& key, void* data_out)
+int FStorage::findCachedValue(const char* key, const uint8_t** data, size_t* size)
 {
+    // a pending write has priority
+    auto index = this->findPendingWrite(key);
+    if(index >= 0)
+    {
+        if(this->pendingWrites[index].erase)
+        {
+            return MBED_ERROR_ITEM_NOT_FOUND;
+        }
+        *data = this->pendingWrites[index].data;
+        *size = this->pendingWrites[index].size;
+        return MBED_SUCCESS;
+    }
+
+    if(this->readCacheEnabled)
+    {
+        index = this->findReadCacheEntry(key);
+        if(index >= 0)
+        {
+            *data = this->readCache[index].data;
+            *size = this->readCache[index].size;
+            return MBED_SUCCESS;
+        }
+        if(this->readCacheComplete)
+        {
+            return MBED_ERROR_ITEM_NOT_FOUND;
+        }
+    }
+    return FSTORAGE_NOT_CACHED;
+}
+
+int FStorage::lookupValue(const char* key, void* buffer, size_t bufferSize, size_t* actual_size, size_t offset)
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
     auto result =
-        (data_out != nullptr)
-        ? MBED_SUCCESS : MBED_ERROR_INVALID_ARGUMENT;
+        this->findCachedValue(key, &data, &size);
 
     if(result == MBED_SUCCESS)
     {
-        TDBStore::info_t info;
+        size_t count = 0;
+        if(offset < size)
+        {
+            count = ((size - offset) < bufferSize) ? (size - offset) : bufferSize;
+            memcpy(buffer, data + offset, count);
+        }
+        *actual_size = count;
+        return MBED_SUCCESS;
+    }
+    if(result != FSTORAGE_NOT_CACHED)
+    {
+        return result;
+    }
+    // one lookup in the store
+    return this->tdbStore->get(key, buffer, bufferSize, actual_size, offset);
+}
 
-        result =
-            this->tdbStore->get_info(key.c_str(), &info);
-        
-        if(result == MBED_SUCCESS)
+int FStorage::findReadCacheEntry(const char* key)
+{
+    for(unsigned int i = 0; i < FSTORAGE_READ_CACHE_ENTRIES; i++)
+    {
+        if(this->readCache[i].used && (strcmp(this->readCache[i].key, key) == 0))
         {
-            size_t actual_size;
+            return i;
+        }
+    }
+    return -1;
+}
 
-            result =
-                this->tdbStore->get(key.c_str(), data_out, info.size, &actual_size);
+void FStorage::updateReadCache(const char* key, const void* data, size_t size, bool erase)
+{
+    if(!this->readCacheEnabled)
+    {
+        return;
+    }
+    auto index = this->findReadCacheEntry(key);
+
+    if(erase)
+    {
+        if(index >= 0)
+        {
+            this->readCache[index].used = false;
         }
+        return;
     }
-    return (result == MBED_SUCCESS) ? true : false;
+
+    if((index < 0) && (strlen(key) <= FSTORAGE_MAX_KEY_LENGTH))
+    {
+        for(unsigned int i = 0; i < FSTORAGE_READ_CACHE_ENTRIES; i++)
+        {
+            if(!this->readCache[i].used)
+            {
+                index = i;
+                strcpy(this->readCache[index].key, key);
+                break;
+            }
+        }
+    }
+
+    if((index >= 0) && (size <= FSTORAGE_READ_CACHE_VALUE_SIZE))
+    {
+        memcpy(this->readCache[index].data, data, size);
+        this->readCache[index].size = size;
+        this->readCache[index].used = true;
+    }
+    else
+    {
+        // the value cannot be held in the cache
+        this->invalidateReadCacheEntry(key);
+    }
+}
+
+void FStorage::invalidateReadCacheEntry(const char* key)
+{
+    auto index = this->findReadCacheEntry(key);
+    if(index >= 0)
+    {
+        this->readCache[index].used = false;
+    }
+    // the cache does no longer reflect all keys of the store
+    this->readCacheComplete = false;
+}
+
+int FStorage::findOldestPendingWrite()
+{
+    int index = -1;
+    for(unsigned int i = 0; i < FSTORAGE_WRITE_CACHE_ENTRIES; i++)
+    {
+        if(this->pendingWrites[i].used)
+        {
+            if((index < 0) || (this->pendingWrites[i].sequence < this->pendingWrites[index].sequence))
+            {
+                index = i;
+            }
+        }
+    }
+    return index;
+}
+
+bool FStorage::commitPendingWrite(unsigned int index)
+{
+    auto& entry = this->pendingWrites[index];
+
+    auto start = micros();
+
+    int result;
+    if(entry.erase)
+    {
+        result = this->deleteValue(entry.key);
+
+        // nothing to erase is not an error
+        if(result == MBED_ERROR_ITEM_NOT_FOUND)
+        {
+            result = MBED_SUCCESS;
+        }
+    }
+    else
+    {
+        result = this->storeValue(entry.key, entry.data, entry.size);
+    }
+
+    auto duration = micros() - start;
+    if(duration > this->worstCaseCommitTime)
+    {
+        this->worstCaseCommitTime = duration;
+    }
+
+    // the entry is released in any case, a failed operation would block the cache otherwise
+    entry.used = false;
+
+    if(result != MBED_SUCCESS)
+    {
+        // the read cache holds the value which could not be committed
+        this->invalidateReadCacheEntry(entry.key);
+        this->failedCommitCount++;
+        return false;
+    }
+    return true;
+}
+
+bool FStorage::getStatistics(FStorageStatistics& stats_out)
+{
+    if(!this->usageInitialized)
+    {
+        this->initializeUsage();
+    }
+
+    size_t liveBytes = 0;
+    unsigned int keyCount = 0;
+
+    if(!this->scanRecords(&liveBytes, &keyCount))
+    {
+        return false;
+    }
+    this->liveBytesEstimate = liveBytes;
+
+    // the master record is the first record of each area
+    auto baseOffset =
+        this->getRecordSize(FSTORAGE_MASTER_RECORD_KEY_SIZE, FSTORAGE_MASTER_RECORD_DATA_SIZE);
+
+    stats_out.areaSize = this->getAreaSize();
+    stats_out.keyCount = keyCount;
+    stats_out.liveBytes = liveBytes;
+    stats_out.usedBytes = this->appendOffset;
+    stats_out.freeBytes = (stats_out.areaSize > this->appendOffset) ? (stats_out.areaSize - this->appendOffset) : 0;
+    stats_out.reclaimableBytes = (this->appendOffset > (baseOffset + liveBytes)) ? (this->appendOffset - baseOffset - liveBytes) : 0;
+    stats_out.writeCount = this->writeCount;
+    stats_out.eraseCount = this->eraseCount;
+    stats_out.garbageCollectionCount = this->garbageCollectionCount;
+    stats_out.userBytesWritten = this->userBytesWritten;
+    stats_out.flashBytesWritten = this->flashBytesWritten;
+    stats_out.writeAmplification =
+        (this->userBytesWritten > 0) ? ((float)this->flashBytesWritten / (float)this->userBytesWritten) : 0.0f;
+    stats_out.lastCompactionTime = this->lastCompactionTime;
+    stats_out.exact = this->usageExact;
+
+    return true;
 }
 
-bool FStorage::eraseData(const String& key)
+bool FStorage::compact(size_t minReclaimableBytes)
 {
+    // pending operations are committed first, so their outdated records are released as well
+    this->flush();
+
+    if(!this->usageInitialized)
+    {
+        this->initializeUsage();
+    }
+
+    size_t liveBytes = 0;
+    unsigned int keyCount = 0;
+
+    if(!this->scanRecords(&liveBytes, &keyCount))
+    {
+        return false;
+    }
+    this->liveBytesEstimate = liveBytes;
+
+    auto baseOffset =
+        this->getRecordSize(FSTORAGE_MASTER_RECORD_KEY_SIZE, FSTORAGE_MASTER_RECORD_DATA_SIZE);
+
+    size_t reclaimable = (this->appendOffset > (baseOffset + liveBytes)) ? (this->appendOffset - baseOffset - liveBytes) : 0;
+
+    if(reclaimable < minReclaimableBytes)
+    {
+        return false;
+    }
+
+#ifndef FSTORAGE_FORCED_GARBAGE_COLLECTION
+    // the garbage collection can not be triggered, it takes place during a later write operation
+    return false;
+#else
+    // TDBStore has no public garbage collection method, but it collects the garbage when a record does not fit in the active area.
+    // A record with the size of the whole area never fits, so the incremental set performs the garbage collection and then fails
+    // with MEDIA_FULL before anything is written.
+    KVStore::set_handle_t handle;
+
+    auto start = micros();
     auto result =
-        this->tdbStore->remove(key.c_str());
+        this->tdbStore->set_start(&handle, FSTORAGE_COMPACTION_KEY, this->getAreaSize(), 0);
 
-    return (result == MBED_SUCCESS) ? true : false;
+    if(result == MBED_SUCCESS)
+    {
+        // not expected - release the handle, the finalization fails since no data was added
+        this->tdbStore->set_finalize(handle);
+        return false;
+    }
+    if(result != MBED_ERROR_MEDIA_FULL)
+    {
+        return false;
+    }
+    this->lastCompactionTime = micros() - start;
+
+    this->garbageCollectionCount++;
+    this->flashBytesWritten += (baseOffset + liveBytes);
+    this->appendOffset = baseOffset + liveBytes;
+    this->usageExact = true;
+
+    return true;
+#endif
+}
+
+int FStorage::storeValue(const char* key, const void* data, size_t size)
+{
+    auto result =
+        this->tdbStore->set(key, data, size, 0);
+
+    if(result == MBED_SUCCESS)
+    {
+        auto keySize = strlen(key);
+
+        // the garbage collection (if any) took place before the record was written
+        this->accountRecord(
+            this->getRecordSize(keySize, size)
+        );
+        this->writeCount++;
+        this->userBytesWritten += (keySize + size);
+    }
+    return result;
+}
+
+int FStorage::deleteValue(const char* key)
+{
+    auto result =
+        this->tdbStore->remove(key);
+
+    if(result == MBED_SUCCESS)
+    {
+        // an erase is stored as a record without data
+        auto keySize = strlen(key);
+
+        this->accountRecord(
+            this->getRecordSize(keySize, 0)
+        );
+        this->eraseCount++;
+        this->userBytesWritten += keySize;
+    }
+    return result;
+}
+
+size_t FStorage::getAreaSize()
+{
+    // the block device is split into two areas of equal size (the available size is aligned to two sectors)
+    return this->limits.available_size / 2;
+}
+
+size_t FStorage::getRecordSize(size_t keySize, size_t dataSize)
+{
+    // header, key and data are aligned to the program unit of the flash
+    size_t programSize = this->iapBlockDevice->get_program_size();
+
+    if(programSize == 0)
+    {
+        programSize = 1;
+    }
+    auto align = [programSize](size_t val) {
+        return ((val + programSize - 1) / programSize) * programSize;
+    };
+    return align(FSTORAGE_RECORD_HEADER_SIZE) + align(keySize) + align(dataSize);
+}
+
+bool FStorage::scanRecords(size_t* liveBytes_out, unsigned int* keyCount_out)
+{
+    KVStore::iterator_t it;
+
+    auto result =
+        this->tdbStore->iterator_open(&it);
+
+    if(result != MBED_SUCCESS)
+    {
+        return false;
+    }
+
+    // the maximum key length of TDBStore
+    char key[KVStore::MAX_KEY_SIZE];
+    size_t liveBytes = 0;
+    unsigned int keyCount = 0;
+
+    while(this->tdbStore->iterator_next(it, key, sizeof(key)) == MBED_SUCCESS)
+    {
+        KVStore::info_t info;
+        if(this->tdbStore->get_info(key, &info) == MBED_SUCCESS)
+        {
+            liveBytes += this->getRecordSize(strlen(key), info.size);
+            keyCount++;
+        }
+    }
+    this->tdbStore->iterator_close(it);
+
+    *liveBytes_out = liveBytes;
+    *keyCount_out = keyCount;
+    return true;
+}
+
+void FStorage::initializeUsage()
+{
+    size_t liveBytes = 0;
+    unsigned int keyCount = 0;
+
+    if(!this->scanRecords(&liveBytes, &keyCount))
+    {
+        return;
+    }
+    this->liveBytesEstimate = liveBytes;
+    this->usageScanPending = false;
+
+    if(!this->usageInitialized)
+    {
+        // the outdated records in the active area are unknown at startup, so the area is assumed to be compact
+        this->appendOffset =
+            this->getRecordSize(FSTORAGE_MASTER_RECORD_KEY_SIZE, FSTORAGE_MASTER_RECORD_DATA_SIZE) + liveBytes;
+
+        this->usageExact = false;
+        this->usageInitialized = true;
+    }
+}
+
+void FStorage::accountRecord(size_t recordSize)
+{
+    this->flashBytesWritten += recordSize;
+
+    // the records are scanned later (onLoop(), getStatistics() or compact()), a scan would slow down the write
+    if(!this->usageInitialized)
+    {
+        return;
+    }
+
+    if((this->appendOffset + recordSize) > this->getAreaSize())
+    {
+        // the record does not fit in, so TDBStore copies the current records to the other area first,
+        // their size is taken from the last scan and the next idle call of onLoop() scans the records again
+        auto baseOffset =
+            this->getRecordSize(FSTORAGE_MASTER_RECORD_KEY_SIZE, FSTORAGE_MASTER_RECORD_DATA_SIZE) + this->liveBytesEstimate;
+
+        this->garbageCollectionCount++;
+        this->flashBytesWritten += baseOffset;
+        this->appendOffset = baseOffset;
+        this->usageScanPending = true;
+    }
+    this->appendOffset += recordSize;
 }
 
 bool FStorage::getFlashIAPLimits(PFlashIAPLimits limits_out)
@@ -243,4 +947,123 @@ bool FStorage::getFlashIAPLimits(PFlashIAPLimits limits_out)
     limits_out->available_size = available_size;
 
     return true;
-}
\ No newline at end of file
+}
+bool FStorageRecord::writeString(const char* name, const String& value)
+{
+    return this->writeData(name, value.c_str(), value.length());
+}
+
+bool FStorageRecord::writeUInt(const char* name, unsigned int value)
+{
+    return this->writeData(name, &value, sizeof(unsigned int));
+}
+
+bool FStorageRecord::writeData(const char* name, const void* data, size_t dataSize)
+{
+    auto nameLength = strlen(name);
+
+    if((nameLength == 0) || (nameLength > 255) || (dataSize > 255))
+    {
+        return false;
+    }
+
+    // the capacity is checked before the old value is removed, so a failed write keeps the old value
+    size_t oldEntrySize = 0;
+    auto pos = this->find(name);
+    if(pos >= 0)
+    {
+        oldEntrySize = nameLength + this->buffer[pos + 1 + nameLength] + 2;
+    }
+    if((this->used - oldEntrySize + nameLength + dataSize + 2) > FSTORAGE_RECORD_SIZE)
+    {
+        return false;
+    }
+    this->remove(name);
+
+    this->buffer[this->used] = static_cast<uint8_t>(nameLength);
+    memcpy(&this->buffer[this->used + 1], name, nameLength);
+    this->buffer[this->used + 1 + nameLength] = static_cast<uint8_t>(dataSize);
+    memcpy(&this->buffer[this->used + 2 + nameLength], data, dataSize);
+
+    this->used += (nameLength + dataSize + 2);
+    return true;
+}
+
+String FStorageRecord::readString(const char* name) const
+{
+    String value;
+
+    auto pos = this->find(name);
+    if(pos >= 0)
+    {
+        auto nameLength = this->buffer[pos];
+        auto size = this->buffer[pos + 1 + nameLength];
+        value.concat(reinterpret_cast<const char*>(&this->buffer[pos + 2 + nameLength]), size);
+    }
+    return value;
+}
+
+unsigned int FStorageRecord::readUInt(const char* name) const
+{
+    unsigned int value = 0;
+
+    if(!this->readData(name, &value, sizeof(unsigned int)))
+    {
+        value = 0;
+    }
+    return value;
+}
+
+bool FStorageRecord::readData(const char* name, void* data_out, size_t size) const
+{
+    auto pos = this->find(name);
+    if(pos >= 0)
+    {
+        auto nameLength = this->buffer[pos];
+        auto dataSize = this->buffer[pos + 1 + nameLength];
+
+        if(dataSize <= size)
+        {
+            memcpy(data_out, &this->buffer[pos + 2 + nameLength], dataSize);
+            return true;
+        }
+    }
+    return false;
+}
+
+int FStorageRecord::find(const char* name) const
+{
+    auto nameLength = strlen(name);
+    size_t pos = 0;
+
+    while((pos + 1) < this->used)
+    {
+        auto entryNameLength = this->buffer[pos];
+        auto sizePos = pos + 1 + entryNameLength;
+
+        if((sizePos >= this->used) || ((sizePos + 1 + this->buffer[sizePos]) > this->used))
+        {
+            // corrupted record
+            break;
+        }
+        if((entryNameLength == nameLength) && (memcmp(&this->buffer[pos + 1], name, nameLength) == 0))
+        {
+            return static_cast<int>(pos);
+        }
+        pos = sizePos + 1 + this->buffer[sizePos];
+    }
+    return -1;
+}
+
+void FStorageRecord::remove(const char* name)
+{
+    auto pos = this->find(name);
+    if(pos >= 0)
+    {
+        auto nameLength = this->buffer[pos];
+        size_t entrySize = nameLength + this->buffer[pos + 1 + nameLength] + 2;
+
+        memmove(&this->buffer[pos], &this->buffer[pos + entrySize], this->used - (pos + entrySize));
+        this->used -= entrySize;
+    }
+}
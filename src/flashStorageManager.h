@@ -5,15 +5,244 @@
 #include <FlashIAP.h>
 #include <FlashIAPBlockDevice.h>
 #include <TDBStore.h>
+#include <type_traits>
+
+#include "memoryConfig.h"
 
 using namespace mbed;
 
+// the maximum length of a key (without terminator) which can be held in the write cache
+#ifndef FSTORAGE_MAX_KEY_LENGTH
+#define FSTORAGE_MAX_KEY_LENGTH 32
+#endif
+
+// the number of pending writes the write cache can hold
+#ifndef FSTORAGE_WRITE_CACHE_ENTRIES
+#define FSTORAGE_WRITE_CACHE_ENTRIES 4
+#endif
+
+// the maximum size of a value in the write cache, larger values are written directly
+#ifndef FSTORAGE_WRITE_CACHE_VALUE_SIZE
+#define FSTORAGE_WRITE_CACHE_VALUE_SIZE 64
+#endif
+
+// the number of key/value pairs the read cache can hold
+#ifndef FSTORAGE_READ_CACHE_ENTRIES
+#define FSTORAGE_READ_CACHE_ENTRIES 6
+#endif
+
+// the maximum size of a value in the read cache
+#ifndef FSTORAGE_READ_CACHE_VALUE_SIZE
+#define FSTORAGE_READ_CACHE_VALUE_SIZE 32
+#endif
+
+// the size of the stack buffer for reading strings (longer strings need more than one lookup)
+#ifndef FSTORAGE_READ_BUFFER_SIZE
+#define FSTORAGE_READ_BUFFER_SIZE 64
+#endif
+
+// the maximum size of a record (see FStorageRecord)
+#ifndef FSTORAGE_RECORD_SIZE
+#define FSTORAGE_RECORD_SIZE 96
+#endif
+
+// the size of the header TDBStore writes in front of each record (used for the usage estimation)
+#ifndef FSTORAGE_RECORD_HEADER_SIZE
+#define FSTORAGE_RECORD_HEADER_SIZE 24
+#endif
+
+// the length of a hashed key (see FStorageKey)
+#define FSTORAGE_HASHED_KEY_LENGTH  9
+
+// internal result code: the value is not in one of the caches
+#define FSTORAGE_NOT_CACHED 1
+
 typedef struct _FlashIAPLimits {
   size_t flash_size;
   uint32_t start_address;
   uint32_t available_size;
 } FlashIAPLimits, *PFlashIAPLimits;
 
+/**
+ * @brief Usage statistics of the flash storage (see FStorage::getStatistics(...)).
+ * TDBStore splits the storage into two areas: records are appended to the active area, if a record does not fit in, the current records
+ * are copied to the other area (garbage collection) which erases the outdated records. The values marked as estimated are calculated from
+ * the operations since startup, outdated records written before startup are not included until the first compaction (see FStorage::compact(...)).
+ */
+typedef struct _FStorageStatistics {
+    // the size of one area (the capacity of the store)
+    size_t areaSize;
+    // the number of stored keys
+    unsigned int keyCount;
+    // bytes occupied by the current records (including the record overhead)
+    size_t liveBytes;
+    // bytes occupied in the active area by current and outdated records (estimated)
+    size_t usedBytes;
+    // bytes left in the active area until the next garbage collection (estimated)
+    size_t freeBytes;
+    // bytes occupied by outdated records which are released by a garbage collection (estimated)
+    size_t reclaimableBytes;
+    // the number of write and erase operations committed to flash since startup
+    unsigned long writeCount;
+    unsigned long eraseCount;
+    // the number of garbage collections since startup (estimated, except the ones triggered by compact())
+    unsigned long garbageCollectionCount;
+    // the bytes of the keys and values passed to the store
+    unsigned long userBytesWritten;
+    // the bytes programmed to flash: records, erase records and the copies of the garbage collections (estimated)
+    unsigned long flashBytesWritten;
+    // flashBytesWritten / userBytesWritten
+    float writeAmplification;
+    // the duration of the last compaction in microseconds
+    unsigned long lastCompactionTime;
+    // true if the estimated values are exact (a compaction was performed since startup)
+    bool exact;
+} FStorageStatistics, *PFStorageStatistics;
+
+
+/**
+ * @brief A fixed-size storage key. The key is a 32bit value, stored as a text of FSTORAGE_HASHED_KEY_LENGTH characters ('#' and 8 hex digits),
+ * so the key needs no heap memory and all hashed keys have the same length. Create it from a name with the FSTORAGE_KEY("name") macro
+ * (the name is hashed at compile time) or from a numeric ID. Keys written as plain text are not affected, both forms can be used side by side.
+ */
+class FStorageKey
+{
+public:
+    constexpr explicit FStorageKey(uint32_t id)
+        : id(id) {}
+
+    // 32bit FNV-1a hash of a name
+    static constexpr uint32_t hash(const char* name, uint32_t h = 2166136261UL){
+        return (*name == '\0') ? h : hash(name + 1, hashByte(h, (uint8_t)(*name)));
+    }
+
+    // derive a key for an indexed item (e.g. a property ID) from this key
+    constexpr FStorageKey withIndex(uint32_t index) const {
+        return FStorageKey(
+            hashByte(hashByte(hashByte(hashByte(this->id, index & 0xFF), (index >> 8) & 0xFF), (index >> 16) & 0xFF), (index >> 24) & 0xFF)
+        );
+    }
+
+    constexpr uint32_t getID() const {
+        return this->id;
+    }
+
+    // the text form of the key
+    typedef struct _KEYTEXT {
+        char key[FSTORAGE_HASHED_KEY_LENGTH + 1];
+    } KeyText;
+
+    KeyText toText() const {
+        static const char hexDigits[] = "0123456789abcdef";
+
+        KeyText text;
+        text.key[0] = '#';
+        for(unsigned int i = 0; i < 8; i++){
+            text.key[8 - i] = hexDigits[(this->id >> (i * 4)) & 0x0F];
+        }
+        text.key[FSTORAGE_HASHED_KEY_LENGTH] = '\0';
+        return text;
+    }
+
+private:
+    uint32_t id;
+
+    static constexpr uint32_t hashByte(uint32_t h, uint8_t b){
+        return (h ^ b) * 16777619UL;
+    }
+};
+
+/**
+ * @brief Create a hashed key from a name (the hash is calculated at compile time)
+ * 
+ */
+#define FSTORAGE_KEY(name)  FStorageKey(std::integral_constant<uint32_t, FStorageKey::hash(name)>::value)
+
+/**
+ * @brief A set of values which is written to (and read from) the storage as one record. All values are stored with one flash write,
+ * so after a power loss either all or none of the values are updated.
+ * Usage: stage the values with the write methods and commit them with FlashStorageManager.writeRecord(key, record).
+ */
+class FStorageRecord
+{
+public:
+    FStorageRecord()
+        : used(0) {}
+
+    /**
+     * @brief Stage a string value. An existing value with the same name is replaced.
+     * 
+     * @param name The name of the value inside the record
+     * @param value The value
+     * @return bool - false if the record capacity (FSTORAGE_RECORD_SIZE) is exhausted
+     */
+    bool writeString(const char* name, const String& value);
+
+    /**
+     * @brief Stage an unsigned int value. An existing value with the same name is replaced.
+     * 
+     * @param name The name of the value inside the record
+     * @param value The value
+     * @return bool - false if the record capacity (FSTORAGE_RECORD_SIZE) is exhausted
+     */
+    bool writeUInt(const char* name, unsigned int value);
+
+    /**
+     * @brief Stage a variable data set. An existing value with the same name is replaced.
+     * 
+     * @param name The name of the value inside the record
+     * @param data Pointer to the data
+     * @param dataSize Size of the data (max. 255 bytes)
+     * @return bool - false if the record capacity (FSTORAGE_RECORD_SIZE) is exhausted
+     */
+    bool writeData(const char* name, const void* data, size_t dataSize);
+
+    /**
+     * @brief Read a string value
+     * 
+     * @param name The name of the value inside the record
+     * @return String - the value or an empty string if the value does not exist
+     */
+    String readString(const char* name) const;
+
+    /**
+     * @brief Read an unsigned int value
+     * 
+     * @param name The name of the value inside the record
+     * @return unsigned int - the value or zero if the value does not exist
+     */
+    unsigned int readUInt(const char* name) const;
+
+    /**
+     * @brief Read a variable data set
+     * 
+     * @param name The name of the value inside the record
+     * @param data_out Pointer to an object to receive the data
+     * @param size The size of the object
+     * @return bool - false if the value does not exist or is larger than the object
+     */
+    bool readData(const char* name, void* data_out, size_t size) const;
+
+    // check if the record contains a value with the given name
+    bool contains(const char* name) const {
+        return this->find(name) >= 0;
+    }
+
+    // remove all values
+    void clear(){
+        this->used = 0;
+    }
+
+private:
+    friend class FStorage;
+
+    // the values are stored in sequence: name length (1 byte), name, value size (1 byte), value
+    uint8_t buffer[FSTORAGE_RECORD_SIZE];
+    size_t used;
+
+    int find(const char* name) const;
+    void remove(const char* name);
+};
 
 class FStorage
 {
@@ -25,7 +254,11 @@ public:
             return flashStorageManagerInst;
         }
         else {
+#ifdef LAROOMY_STATIC_ALLOCATION
+            flashStorageManagerInst = new (instanceStorage) FStorage();
+#else
             flashStorageManagerInst = new FStorage();
+#endif
             if(flashStorageManagerInst != nullptr){
                 flash_storage_manager_inst_exist = true;
             }
@@ -41,7 +274,7 @@ public:
      * 
      * @return bool - true if successful or false otherwise
      */
-    bool writeString(const String& key, const String& value);
+    bool writeString(const char* key, const char* value);
 
     /**
      * @brief Write an unsigned int value to storage
@@ -51,7 +284,7 @@ public:
      * 
      * @return bool - true if successful or false otherwise
      */
-    bool writeUInt(const String& key, unsigned int value);
+    bool writeUInt(const char* key, unsigned int value);
 
     /**
      * @brief Write an integer value to storage
@@ -62,7 +295,7 @@ public:
      * 
      * @return bool - true if successful or false otherwise 
      */
-    bool writeInt(const String& key, int value);
+    bool writeInt(const char* key, int value);
 
     /**
      * @brief Write a variable data set to storage
@@ -73,7 +306,7 @@ public:
      * 
      * @return bool - true if successful or false otherwise 
      */
-    bool writeData(const String& key, void* data, size_t dataSize);
+    bool writeData(const char* key, const void* data, size_t dataSize);
 
     /**
      * @brief Read a string value from storage
@@ -81,7 +314,7 @@ public:
      * @param key The key that identifies the value. Must not include '*' '/' '?' ':' ';'
      * @return String - the value. If the key is not found the value is empty.
      */
-    String readString(const String& key);
+    String readString(const char* key);
 
     /**
      * @brief Read an unsigned int value from storage
@@ -89,7 +322,7 @@ public:
      * @param key The key that identifies the value. Must not include '*' '/' '?' ':' ';'
      * @return unsigned int - The stored value or zero if the value does not exist.
      */
-    unsigned int readUInt(const String& key);
+    unsigned int readUInt(const char* key);
 
     /**
      * @brief Read an integer value from storage
@@ -97,7 +330,7 @@ public:
      * @param key The key that identifies the value. Must not include '*' '/' '?' ':' ';'
      * @return int - The stored value or zero if the value does not exist.
      */
-    int readInt(const String& key);
+    int readInt(const char* key);
 
     /**
      * @brief Read a variable data set from storage
@@ -107,7 +340,30 @@ public:
      *  
      * @return bool - true if successful or false otherwise 
      */
-    bool readData(const String& key, void* data_out);
+    bool readData(const char* key, void* data_out);
+
+    /**
+     * @brief Read a variable data set from storage with a known maximum size (this requires only one lookup)
+     * 
+     * @param key The key that identifies the value. Must not include '*' '/' '?' ':' ';'
+     * @param data_out Pointer to an object to receive the data
+     * @param size The size of the object
+     * @param actual_size_out Receives the number of bytes read (optional)
+     * 
+     * @return bool - true if successful or false otherwise 
+     */
+    bool readData(const char* key, void* data_out, size_t size, size_t* actual_size_out = nullptr);
+
+    /**
+     * @brief Enable or disable the read cache. When enabled, the store is scanned once and all keys and values are loaded into RAM
+     * (as far as they fit: FSTORAGE_READ_CACHE_ENTRIES / FSTORAGE_READ_CACHE_VALUE_SIZE / FSTORAGE_MAX_KEY_LENGTH). Subsequent reads of cached keys need no flash access,
+     * if all keys fit into the cache, reading a key which does not exist needs no flash access either. The cache is kept up to date on write and erase.
+     * NOTE: Enable the cache before the binding controller or the pin storage controller is used the first time, to load their data with the same scan.
+     * 
+     * @param enable True to enable the cache
+     * @return bool - false if the store could not be scanned
+     */
+    bool enableReadCache(bool enable);
 
     /**
      * @brief Erase the stored value with the given key
@@ -116,13 +372,179 @@ public:
      * 
      * @return bool - true if successful or false otherwise
      */
-    bool eraseData(const String& key);
+    bool eraseData(const char* key);
+
+    /**
+     * @brief Write all values of a record with one flash write (atomic)
+     * 
+     * @param key The key that identifies the record. Must not include '*' '/' '?' ':' ';'
+     * @param record The record to store
+     * 
+     * @return bool - true if successful or false otherwise
+     */
+    bool writeRecord(const char* key, const FStorageRecord& record);
+
+    /**
+     * @brief Read a record
+     * 
+     * @param key The key that identifies the record. Must not include '*' '/' '?' ':' ';'
+     * @param record_out The record to receive the values
+     * 
+     * @return bool - true if successful or false if the record does not exist
+     */
+    bool readRecord(const char* key, FStorageRecord& record_out);
+
+    // overloads for String keys and values
+    bool writeString(const char* key, const String& value){
+        return this->writeString(key, value.c_str());
+    }
+    bool writeString(const String& key, const String& value){
+        return this->writeString(key.c_str(), value.c_str());
+    }
+    bool writeUInt(const String& key, unsigned int value){
+        return this->writeUInt(key.c_str(), value);
+    }
+    bool writeInt(const String& key, int value){
+        return this->writeInt(key.c_str(), value);
+    }
+    bool writeData(const String& key, const void* data, size_t dataSize){
+        return this->writeData(key.c_str(), data, dataSize);
+    }
+    String readString(const String& key){
+        return this->readString(key.c_str());
+    }
+    unsigned int readUInt(const String& key){
+        return this->readUInt(key.c_str());
+    }
+    int readInt(const String& key){
+        return this->readInt(key.c_str());
+    }
+    bool readData(const String& key, void* data_out){
+        return this->readData(key.c_str(), data_out);
+    }
+    bool readData(const String& key, void* data_out, size_t size, size_t* actual_size_out = nullptr){
+        return this->readData(key.c_str(), data_out, size, actual_size_out);
+    }
+    bool eraseData(const String& key){
+        return this->eraseData(key.c_str());
+    }
+    bool writeRecord(const String& key, const FStorageRecord& record){
+        return this->writeRecord(key.c_str(), record);
+    }
+    bool readRecord(const String& key, FStorageRecord& record_out){
+        return this->readRecord(key.c_str(), record_out);
+    }
+
+    // overloads for hashed keys (see FStorageKey)
+    bool writeString(const FStorageKey& key, const char* value){
+        return this->writeString(key.toText().key, value);
+    }
+    bool writeString(const FStorageKey& key, const String& value){
+        return this->writeString(key.toText().key, value.c_str());
+    }
+    bool writeUInt(const FStorageKey& key, unsigned int value){
+        return this->writeUInt(key.toText().key, value);
+    }
+    bool writeInt(const FStorageKey& key, int value){
+        return this->writeInt(key.toText().key, value);
+    }
+    bool writeData(const FStorageKey& key, const void* data, size_t dataSize){
+        return this->writeData(key.toText().key, data, dataSize);
+    }
+    String readString(const FStorageKey& key){
+        return this->readString(key.toText().key);
+    }
+    unsigned int readUInt(const FStorageKey& key){
+        return this->readUInt(key.toText().key);
+    }
+    int readInt(const FStorageKey& key){
+        return this->readInt(key.toText().key);
+    }
+    bool readData(const FStorageKey& key, void* data_out){
+        return this->readData(key.toText().key, data_out);
+    }
+    bool readData(const FStorageKey& key, void* data_out, size_t size, size_t* actual_size_out = nullptr){
+        return this->readData(key.toText().key, data_out, size, actual_size_out);
+    }
+    bool eraseData(const FStorageKey& key){
+        return this->eraseData(key.toText().key);
+    }
+    bool writeRecord(const FStorageKey& key, const FStorageRecord& record){
+        return this->writeRecord(key.toText().key, record);
+    }
+    bool readRecord(const FStorageKey& key, FStorageRecord& record_out){
+        return this->readRecord(key.toText().key, record_out);
+    }
 
     // check if there was an initialization error
     bool initSuccess(){
         return this->err;
     }
 
+    /**
+     * @brief Enable or disable the write cache. If enabled, write and erase operations are stored in RAM and committed to flash in the onLoop() method
+     * (one operation per call) or on flush(). Repeated writes to the same key are coalesced to a single flash write and reads return the pending values.
+     * NOTE: Pending operations are lost on reset or power loss. Each committed operation is atomic (the old or the new value is stored, never a mix),
+     * the operations are committed in the order of their first write. Call flush() before a reset or when entering a low power mode.
+     * Disabling the cache flushes all pending operations.
+     * 
+     * @param enable True to enable the cache
+     */
+    void enableWriteBehindCache(bool enable);
+
+    /**
+     * @brief Commit all pending operations of the write cache to flash
+     * 
+     * @return bool - true if all operations succeeded
+     */
+    bool flush();
+
+    /**
+     * @brief Commit the oldest pending operation of the write cache. This method is called periodically by the storage task of the
+     * LaRoomyApi scheduler (see LAROOMY_STORAGE_FLUSH_INTERVAL), if the api is not used, call it in the loop of the application.
+     * If no operation is pending, the records are scanned for the usage statistics after startup and after a garbage collection.
+     */
+    void onLoop();
+
+    // the number of operations in the write cache which are not committed
+    unsigned int getPendingWriteCount();
+
+    // the longest time in microseconds a single commit of the write cache took (this is the worst-case loop stall caused by the cache)
+    unsigned long getWorstCaseCommitTime(){
+        return this->worstCaseCommitTime;
+    }
+
+    // the number of cached operations which could not be committed (the operation is discarded)
+    unsigned int getFailedCommitCount(){
+        return this->failedCommitCount;
+    }
+
+    /**
+     * @brief Get the usage statistics of the store. The keys of the store are scanned to determine the current records,
+     * operations in the write cache are not included.
+     * 
+     * @param stats_out Receives the statistics
+     * @return bool - false if the store could not be scanned
+     */
+    bool getStatistics(FStorageStatistics& stats_out);
+
+    /**
+     * @brief Perform the garbage collection of the store now, instead of during a later write operation. A garbage collection erases
+     * a flash area and copies all current records, so this may take a long time (up to seconds). Call it while the device is idle,
+     * e.g. when no BLE connection exists. The write cache is flushed first.
+     * Example: if(!LaRoomyApi.isConnected()){ FlashStorageManager.compact(2048); }
+     * 
+     * @param minReclaimableBytes The compaction is skipped if the estimated number of reclaimable bytes is less than this value
+     * (0 = always compact, this also makes the statistics exact)
+     * @return bool - true if the compaction was performed (always false if the Mbed OS version is not 6, compact() relies on its TDBStore)
+     */
+    bool compact(size_t minReclaimableBytes = 0);
+
+    // check if the instance exists (without creating it)
+    static bool isCreated(){
+        return flash_storage_manager_inst_exist;
+    }
+
 private:
     FlashIAPLimits limits;
 
@@ -130,12 +552,85 @@ private:
 
     static bool flash_storage_manager_inst_exist;
     static FStorage* flashStorageManagerInst;
+#ifdef LAROOMY_STATIC_ALLOCATION
+    static uint8_t instanceStorage[];
+
+    // storage for the block device and the key-value store object
+    alignas(TDBStore) uint8_t tdbStoreStorage[sizeof(TDBStore)];
+    alignas(FlashIAPBlockDevice) uint8_t iapBlockDeviceStorage[sizeof(FlashIAPBlockDevice)];
+#endif
 
     TDBStore* tdbStore = nullptr;
     FlashIAPBlockDevice* iapBlockDevice = nullptr;
 
+    // a pending operation in the write cache
+    typedef struct _PENDINGWRITE {
+        bool used;
+        bool erase;
+        unsigned long sequence;
+        size_t size;
+        char key[FSTORAGE_MAX_KEY_LENGTH + 1];
+        uint8_t data[FSTORAGE_WRITE_CACHE_VALUE_SIZE];
+    } PendingWrite;
+
+    // a key/value pair in the read cache
+    typedef struct _READCACHEENTRY {
+        bool used;
+        size_t size;
+        char key[FSTORAGE_MAX_KEY_LENGTH + 1];
+        uint8_t data[FSTORAGE_READ_CACHE_VALUE_SIZE];
+    } ReadCacheEntry;
+
+    bool writeBehindEnabled = false;
+    PendingWrite pendingWrites[FSTORAGE_WRITE_CACHE_ENTRIES];
+
+    bool readCacheEnabled = false;
+    bool readCacheComplete = false;
+    ReadCacheEntry readCache[FSTORAGE_READ_CACHE_ENTRIES];
+    unsigned long writeSequence = 0;
+    unsigned long worstCaseCommitTime = 0;
+    unsigned int failedCommitCount = 0;
+
+    // usage statistics (see getStatistics())
+    bool usageInitialized = false;
+    bool usageExact = false;
+    size_t appendOffset = 0;
+    // the size of the current records at the last scan, a scan is pending after a predicted garbage collection
+    size_t liveBytesEstimate = 0;
+    bool usageScanPending = false;
+    unsigned long writeCount = 0;
+    unsigned long eraseCount = 0;
+    unsigned long garbageCollectionCount = 0;
+    unsigned long userBytesWritten = 0;
+    unsigned long flashBytesWritten = 0;
+    unsigned long lastCompactionTime = 0;
+
     FStorage();
 
+    // write or erase through the cache if enabled
+    bool setValue(const char* key, const void* data, size_t size);
+    bool removeValue(const char* key);
+
+    // write or erase in the store and update the statistics
+    int storeValue(const char* key, const void* data, size_t size);
+    int deleteValue(const char* key);
+
+    size_t getAreaSize();
+    size_t getRecordSize(size_t keySize, size_t dataSize);
+    bool scanRecords(size_t* liveBytes_out, unsigned int* keyCount_out);
+    void initializeUsage();
+    void accountRecord(size_t recordSize);
+
+    bool stageWrite(const char* key, const void* data, size_t size, bool erase);
+    int findPendingWrite(const char* key);
+    int findCachedValue(const char* key, const uint8_t** data, size_t* size);
+    int lookupValue(const char* key, void* buffer, size_t bufferSize, size_t* actual_size, size_t offset = 0);
+    int findReadCacheEntry(const char* key);
+    void updateReadCache(const char* key, const void* data, size_t size, bool erase);
+    void invalidateReadCacheEntry(const char* key);
+    int findOldestPendingWrite();
+    bool commitPendingWrite(unsigned int index);
+
     bool getFlashIAPLimits(PFlashIAPLimits limits_out);
 };
 
@@ -0,0 +1,108 @@
+#ifndef LR_MEMORY_CONFIG_H
+#define LR_MEMORY_CONFIG_H
+
+#include <new>
+
+/*
+    Memory configuration of the library
+
+    By default the library objects are created on the heap when they are accessed for the first time and the property, group and
+    state collections grow at runtime. Define LAROOMY_STATIC_ALLOCATION (e.g. as build flag: -D LAROOMY_STATIC_ALLOCATION) to place
+    the singleton objects and all property, group and state storage in static memory instead. In this mode the capacities below are
+    fixed at compile time, elements beyond the capacity are discarded. All capacity values can be overridden the same way.
+*/
+
+// the maximum number of properties (only applied in static allocation mode)
+#ifndef LAROOMY_MAX_PROPERTIES
+#define LAROOMY_MAX_PROPERTIES  32
+#endif
+
+// the maximum number of groups (only applied in static allocation mode)
+#ifndef LAROOMY_MAX_GROUPS
+#define LAROOMY_MAX_GROUPS  8
+#endif
+
+// the maximum number of states per complex property type (only applied in static allocation mode)
+#ifndef LAROOMY_MAX_COMPLEX_STATES
+#define LAROOMY_MAX_COMPLEX_STATES  4
+#endif
+
+// the maximum size of a single received transmission (the characteristic value size)
+#ifndef LAROOMY_MAX_PAYLOAD_SIZE
+#define LAROOMY_MAX_PAYLOAD_SIZE    255
+#endif
+
+// the number of received transmissions which can be buffered until they are processed in the onLoop() method
+#ifndef LAROOMY_RX_QUEUE_DEPTH
+#define LAROOMY_RX_QUEUE_DEPTH  4
+#endif
+
+// the number of outgoing transmissions (fragments) which can be buffered for the protocol thread (see startProtocolThread())
+#ifndef LAROOMY_TX_QUEUE_DEPTH
+#define LAROOMY_TX_QUEUE_DEPTH  32
+#endif
+
+// the number of protocol events (e.g. connection state changes) which can be buffered for the application thread
+#ifndef LAROOMY_EVENT_QUEUE_DEPTH
+#define LAROOMY_EVENT_QUEUE_DEPTH   8
+#endif
+
+// the number of property events which can be buffered in the event queue mode (see LaRoomyAppImplementation::enableEventQueueMode(...))
+#ifndef LAROOMY_PROPERTY_EVENT_QUEUE_DEPTH
+#define LAROOMY_PROPERTY_EVENT_QUEUE_DEPTH  16
+#endif
+
+// the stack size in bytes of the protocol thread, in static allocation mode the stack is reserved in static memory
+#ifndef LAROOMY_PROTOCOL_THREAD_STACK_SIZE
+#define LAROOMY_PROTOCOL_THREAD_STACK_SIZE  4096
+#endif
+
+// the size of the buffer which holds the property and group descriptors (see StringArena.h)
+#ifndef LAROOMY_STRING_ARENA_SIZE
+#define LAROOMY_STRING_ARENA_SIZE   2048
+#endif
+
+// the maximum size of the property state snapshot (see LaRoomyAppImplementation::enableStatePersistence(...)), the buffer is
+// located on the stack while the snapshot is created or restored, states which do not fit in are not persisted
+#ifndef LAROOMY_STATE_SNAPSHOT_SIZE
+#define LAROOMY_STATE_SNAPSHOT_SIZE 256
+#endif
+
+// the default time in milliseconds between the first state change and the snapshot write
+#ifndef LAROOMY_STATE_SNAPSHOT_DEBOUNCE_TIME
+#define LAROOMY_STATE_SNAPSHOT_DEBOUNCE_TIME    5000
+#endif
+
+// the number of task slots of the scheduler (see TaskScheduler.h), the library occupies up to three slots, each RGBControl
+// attached to the scheduler one more
+#ifndef LAROOMY_MAX_SCHEDULED_TASKS
+#define LAROOMY_MAX_SCHEDULED_TASKS 8
+#endif
+
+// the default interval in milliseconds for polling the bluetooth stack and processing the received transmissions,
+// 0 polls on every call of onLoop() (the protocol thread waits at least one millisecond between two polls)
+#ifndef LAROOMY_PROTOCOL_POLL_INTERVAL
+#define LAROOMY_PROTOCOL_POLL_INTERVAL  0
+#endif
+
+// the interval in milliseconds for committing the pending writes of the flash storage write cache
+#ifndef LAROOMY_STORAGE_FLUSH_INTERVAL
+#define LAROOMY_STORAGE_FLUSH_INTERVAL  20
+#endif
+
+// the time in milliseconds the bluetooth stack is given to settle between the steps of a stop or restart
+#ifndef LAROOMY_BLE_SETTLE_TIME
+#define LAROOMY_BLE_SETTLE_TIME 100
+#endif
+
+// the maximum number of zones of a RGBZoneControl object (at most 32)
+#ifndef LAROOMY_MAX_RGB_ZONES
+#define LAROOMY_MAX_RGB_ZONES   8
+#endif
+
+// the estimated overhead of a heap block, only used for the memory report
+#ifndef LAROOMY_HEAP_BLOCK_OVERHEAD
+#define LAROOMY_HEAP_BLOCK_OVERHEAD 8
+#endif
+
+#endif // LR_MEMORY_CONFIG_H
@@ -1,22 +1,98 @@
 #include "LaRoomyApi_STM32.h"
 
+// the easing curves are sampled at (EASING_TABLE_SEGMENTS + 1) points, the values between are interpolated
+#define EASING_TABLE_SEGMENTS   64
+#define EASING_SEGMENT_SHIFT    10      // (1 << 16) / EASING_TABLE_SEGMENTS
+
+/**
+ * @brief Easing curve as table in 16 bit fixed point (0..65535), generated at compile time
+ * 
+ */
+class EasingTable {
+public:
+    constexpr EasingTable(RGBFadeEasing easing)
+        : values()
+    {
+        for(uint64_t i = 0; i <= EASING_TABLE_SEGMENTS; i++){
+            uint64_t p = (i << 16) / EASING_TABLE_SEGMENTS;
+            uint64_t v = p;
+
+            switch(easing){
+                case RGBFadeEasing::FADE_EASE_IN:
+                    // p^2
+                    v = (p * p) >> 16;
+                    break;
+                case RGBFadeEasing::FADE_EASE_OUT:
+                    // 1 - (1 - p)^2
+                    v = 0x10000 - (((0x10000 - p) * (0x10000 - p)) >> 16);
+                    break;
+                case RGBFadeEasing::FADE_EASE_IN_OUT:
+                    // smoothstep: 3p^2 - 2p^3
+                    v = ((3 * p * p) >> 16) - ((2 * p * p * p) >> 32);
+                    break;
+                default:
+                    break;
+            }
+            this->values[i] = (v > 0xFFFF) ? 0xFFFF : (uint16_t)v;
+        }
+    }
+
+    uint16_t values[EASING_TABLE_SEGMENTS + 1];
+};
+
+// indexed by RGBFadeEasing
+static constexpr EasingTable easingTables[] = {
+    EasingTable(RGBFadeEasing::FADE_LINEAR),
+    EasingTable(RGBFadeEasing::FADE_EASE_IN),
+    EasingTable(RGBFadeEasing::FADE_EASE_OUT),
+    EasingTable(RGBFadeEasing::FADE_EASE_IN_OUT)
+};
+
+// gamma 2.2 correction of the output values
+static const uint8_t gammaTable[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+// get the eased progress (16 bit fixed point), linear interpolation between the points of the table
+static int32_t easeProgress(RGBFadeEasing easing, uint32_t progress){
+    const uint16_t* table = easingTables[easing].values;
+    uint32_t index = progress >> EASING_SEGMENT_SHIFT;
+    uint32_t fraction = progress & ((1UL << EASING_SEGMENT_SHIFT) - 1);
+
+    return (index >= EASING_TABLE_SEGMENTS)
+        ? 0x10000 : (table[index] + (((uint32_t)(table[index + 1] - table[index]) * fraction) >> EASING_SEGMENT_SHIFT));
+}
+
 RGBControl::RGBControl(pin_size_t RedPin, pin_size_t GreenPin, pin_size_t BluePin)
-    : redPin(RedPin), greenPin(GreenPin), bluePin(BluePin) {}
+    : pwmOutput(RedPin, GreenPin, BluePin), pOutput(&pwmOutput) {}
+
+RGBControl::RGBControl(RGBOutput& output)
+    : pwmOutput(0, 0, 0), pOutput(&output) {}
 
 RGBControl::~RGBControl(){
-    analogWrite(redPin, 0);
-    analogWrite(greenPin, 0);
-    analogWrite(bluePin, 0);
+    this->detachFromScheduler();
+    this->enableTimerDrivenFading(false);
+    this->pOutput->write(0, 0, 0);
 }
 
 void RGBControl::begin(){
-    // config pins
-    pinMode(redPin, OUTPUT);
-    pinMode(greenPin, OUTPUT);
-    pinMode(bluePin, OUTPUT);
-    analogWrite(redPin, 0);
-    analogWrite(greenPin, 0);
-    analogWrite(bluePin, 0);
+    // config output
+    this->pOutput->begin();
 
     // create default color selection
     this->colorSelection.AddItem(Colors::Red);
@@ -36,23 +112,29 @@ void RGBControl::begin(){
 
     // mark as begun
     this->hasBegun = true;
+    this->onOutputChanged();
 }
 
 void RGBControl::end(){
     this->hasBegun = false;
+    if(this->useFadeTicker){
+        this->fadeTicker.detach();
+    }
+    this->fadeProgress = RGB_FADE_PROGRESS_COMPLETE;
     this->tProgram = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
+    this->pKeyframes = nullptr;
     this->redValue = 0;
     this->greenValue = 0;
     this->blueValue = 0;
     this->currentRedValue = 0;
     this->currentGreenValue = 0;
     this->currentBlueValue = 0;
-    analogWrite(redPin, 0);
-    analogWrite(greenPin, 0);
-    analogWrite(bluePin, 0);
+    this->pOutput->end();
 }
 
 void RGBControl::off(){
+    this->pKeyframes = nullptr;
+
     if(this->tProgram != RGBColorTransitionProgram::RCTP_NO_TRANSITION){
         this->tProgram = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
         this->fadeTimeOut = this->tmSaver;
@@ -60,6 +142,7 @@ void RGBControl::off(){
     this->redValue = 0;
     this->greenValue = 0;
     this->blueValue = 0;
+    this->onOutputChanged();
 }
 
 void RGBControl::applyStateChange(const RGBSelectorState& state){
@@ -78,6 +161,8 @@ void RGBControl::applyStateChange(const RGBSelectorState& state){
 
 void RGBControl::changeRGBColor(uint8_t red, uint8_t green, uint8_t blue, RGBTransitionType tType){
 
+    this->pKeyframes = nullptr;
+
     if(this->tProgram != RGBColorTransitionProgram::RCTP_NO_TRANSITION){
         this->fadeTimeOut = this->tmSaver;
         this->tProgram = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
@@ -86,10 +171,12 @@ void RGBControl::changeRGBColor(uint8_t red, uint8_t green, uint8_t blue, RGBTra
     this->greenValue = green;
     this->blueValue = blue;
     this->hardTrans = (tType == RGBTransitionType::HARD_TRANSITION) ? true : false;
+    this->onOutputChanged();
 }
 
 void RGBControl::changeRGBProgram(RGBColorTransitionProgram program, RGBTransitionType tType){
 
+    this->pKeyframes = nullptr;
     this->hardTrans = tType == RGBTransitionType::HARD_TRANSITION ? true : false;
 
     if((program == RGBColorTransitionProgram::RCTP_NO_TRANSITION) && (this->tProgram != RGBColorTransitionProgram::RCTP_NO_TRANSITION))
@@ -105,6 +192,8 @@ void RGBControl::changeRGBProgram(RGBColorTransitionProgram program, RGBTransiti
             if(this->tProgram == RGBColorTransitionProgram::RCTP_NO_TRANSITION){
                 // save the old timeOut value only if there is no program running
                 this->tmSaver = this->fadeTimeOut;
+                // the program timer is not refreshed while the task is suspended, so restart it
+                this->progTimer = millis();
             }
             // if the current condition is off or no program was active -> set the first color immediately
             if((this->redValue == 0 && this->greenValue == 0 && this->blueValue == 0)
@@ -147,6 +236,53 @@ void RGBControl::changeRGBProgram(RGBColorTransitionProgram program, RGBTransiti
             }
         }
     }
+    this->onOutputChanged();
+}
+
+bool RGBControl::runKeyframeProgram(const RGBKEYFRAME* keyframes, unsigned int count, unsigned int repeatCount){
+    if((keyframes == nullptr) || (count == 0)){
+        return false;
+    }
+    // the easing is used as a table index, so a program with an invalid value is rejected
+    for(unsigned int i = 0; i < count; i++){
+        if(keyframes[i].easing > RGBFadeEasing::FADE_EASE_IN_OUT){
+            return false;
+        }
+    }
+    // the keyframe program replaces the color transition program
+    if(this->tProgram != RGBColorTransitionProgram::RCTP_NO_TRANSITION){
+        this->fadeTimeOut = this->tmSaver;
+        this->tProgram = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
+    }
+    this->pKeyframes = keyframes;
+    this->keyframeCount = count;
+    this->keyframeIndex = 0;
+    this->keyframeRepeatCount = repeatCount;
+    this->keyframeRunCount = 0;
+    this->hardTrans = false;
+
+    this->startKeyframe(millis());
+    this->onOutputChanged();
+    return true;
+}
+
+void RGBControl::stopKeyframeProgram(){
+    this->pKeyframes = nullptr;
+}
+
+void RGBControl::startKeyframe(unsigned long startTime){
+    auto keyframe = &this->pKeyframes[this->keyframeIndex];
+
+    this->redValue = keyframe->red;
+    this->greenValue = keyframe->green;
+    this->blueValue = keyframe->blue;
+
+    // at least one millisecond per keyframe, so a keyframe without fade and hold time cannot block the loop
+    this->keyframeTimer = startTime;
+    this->keyframeStepTime = (unsigned long)keyframe->fadeTime + keyframe->holdTime;
+    if(this->keyframeStepTime == 0){
+        this->keyframeStepTime = 1;
+    }
 }
 
 void RGBControl::setCustomColorSelection(ColorCollection& colorSel){
@@ -161,12 +297,156 @@ void RGBControl::setCustomColorSelection(ColorCollection& colorSel){
 }
 
 
-void RGBControl::onLoop(){
+bool RGBControl::attachToScheduler(TaskScheduler& scheduler){
+    this->detachFromScheduler();
 
-    if(!hasBegun){
+    this->taskHandle = scheduler.addTask(&RGBControl::taskFunction, this, 0);
+    if(this->taskHandle == INVALID_TASK_HANDLE){
+        return false;
+    }
+    this->pScheduler = &scheduler;
+    return true;
+}
+
+void RGBControl::detachFromScheduler(){
+    if(this->pScheduler != nullptr){
+        this->pScheduler->removeTask(this->taskHandle);
+        this->pScheduler = nullptr;
+        this->taskHandle = INVALID_TASK_HANDLE;
+    }
+}
+
+void RGBControl::onOutputChanged(){
+    this->startFade();
+
+    if(this->pScheduler != nullptr){
+        this->pScheduler->scheduleTask(this->taskHandle, 0);
+    }
+}
+
+bool RGBControl::enableTimerDrivenFading(bool enable, bool useInternalTicker){
+    if(this->useFadeTicker){
+        this->fadeTicker.detach();
+    }
+    this->fadeProgress = RGB_FADE_PROGRESS_COMPLETE;
+    // the output must be writable from the interrupt, otherwise the fading remains in onLoop()
+    this->timerDrivenFading = enable && this->pOutput->isInterruptSafe();
+
+    // the ticker is a member, so no memory is allocated
+    this->useFadeTicker = this->timerDrivenFading && useInternalTicker;
+    // continue a running fade in the selected mode
+    if(this->hasBegun){
+        this->onOutputChanged();
+    }
+    return (this->timerDrivenFading == enable);
+}
+
+void RGBControl::startFade(){
+    if(this->useFadeTicker){
+        this->fadeTicker.detach();
+    }
+    uint8_t targetValues[3] = { this->redValue, this->greenValue, this->blueValue };
+    unsigned int maxDelta = 0;
+
+    // the fade is shared with the interrupt (an external tick source is not stopped by the detach),
+    // so the current values are read in the critical section as well
+    noInterrupts();
+
+    uint8_t currentValues[3] = { this->currentRedValue, this->currentGreenValue, this->currentBlueValue };
+
+    for(unsigned int i = 0; i < 3; i++){
+        this->fadeStartValues[i] = currentValues[i];
+        this->fadeDelta[i] = (int16_t)targetValues[i] - (int16_t)currentValues[i];
+
+        unsigned int delta = (this->fadeDelta[i] < 0) ? -this->fadeDelta[i] : this->fadeDelta[i];
+        if(delta > maxDelta){
+            maxDelta = delta;
+        }
+    }
+    unsigned long duration;
+
+    if(this->pKeyframes != nullptr){
+        // the keyframe defines the fade
+        duration = this->pKeyframes[this->keyframeIndex].fadeTime;
+        this->activeFadeEasing = (RGBFadeEasing)this->pKeyframes[this->keyframeIndex].easing;
+    }
+    else {
+        // without a fixed duration, the duration results from the largest channel difference (one fade delay per step)
+        duration = (this->fadeDuration > 0) ? this->fadeDuration : (maxDelta * this->fadeTimeOut);
+        this->activeFadeEasing = this->fadeEasing;
+    }
+    auto period = (this->fadeTimeOut > 0) ? this->fadeTimeOut : 1;
+
+    if(this->hardTrans || (maxDelta == 0) || (duration == 0)){
+        this->fadeProgress = RGB_FADE_PROGRESS_COMPLETE;
+    }
+    else {
+        this->activeFadeDuration = duration;
+        this->fadeStartTime = millis();
+        this->fadeTimer = this->fadeStartTime;
+        this->fadeProgress = 0;
+
+        // the progress increment of one tick in timer driven mode
+        this->fadeProgressStep = (uint32_t)(((uint64_t)period << 16) / duration);
+        if(this->fadeProgressStep == 0){
+            this->fadeProgressStep = 1;
+        }
+    }
+    interrupts();
+
+    if(this->fadeProgress == RGB_FADE_PROGRESS_COMPLETE){
+        // set the target immediately
+        this->applyFadeProgress(RGB_FADE_PROGRESS_COMPLETE);
+    }
+    else if(this->useFadeTicker){
+        this->fadeTicker.attach(mbed::callback(this, &RGBControl::onFadeTick), std::chrono::milliseconds(period));
+    }
+}
+
+void RGBControl::onFadeTick(){
+    if(this->fadeProgress >= RGB_FADE_PROGRESS_COMPLETE){
         return;
+    }
+    this->applyFadeProgress(this->fadeProgress + this->fadeProgressStep);
+
+    if((this->fadeProgress >= RGB_FADE_PROGRESS_COMPLETE) && this->useFadeTicker){
+        this->fadeTicker.detach();
+    }
+}
+
+void RGBControl::applyFadeProgress(uint32_t progress){
+    uint8_t* currentValues[3] = { &this->currentRedValue, &this->currentGreenValue, &this->currentBlueValue };
+    uint8_t outputValues[3];
+
+    if(progress > RGB_FADE_PROGRESS_COMPLETE){
+        progress = RGB_FADE_PROGRESS_COMPLETE;
+    }
+    this->fadeProgress = progress;
+
+    auto eased = easeProgress(this->activeFadeEasing, progress);
+
+    for(unsigned int i = 0; i < 3; i++){
+        *currentValues[i] = (uint8_t)(this->fadeStartValues[i] + ((this->fadeDelta[i] * eased + 0x8000) >> 16));
+        outputValues[i] = this->gammaCorrection ? gammaTable[*currentValues[i]] : *currentValues[i];
+    }
+    this->pOutput->write(outputValues[0], outputValues[1], outputValues[2]);
+}
+
+void RGBControl::taskFunction(void* context){
+    auto pControl = reinterpret_cast<RGBControl*>(context);
+    // the task is only scheduled while the output changes
+    pControl->pScheduler->scheduleTask(pControl->taskHandle, pControl->onLoop());
+}
+
+unsigned long RGBControl::onLoop(){
+
+    if(!hasBegun){
+        return SCHEDULER_NO_DEADLINE;
     }    
 
+    // complete the deferred work of the output (e.g. a frame which was set during a transfer)
+    bool outputPending = this->pOutput->update();
+
     // handle program action
     if(millis() > (unsigned long)(this->progTimer + this->progTimeOut)){
 
@@ -190,70 +470,426 @@ void RGBControl::onLoop(){
                 this->greenValue = this->colorSelection.getObjectCoreReferenceAt(this->currentColorIndex)->greenPart;
                 this->blueValue = this->colorSelection.getObjectCoreReferenceAt(this->currentColorIndex)->bluePart;
             }
+            this->startFade();
         }
     }
 
+    // handle the keyframe program (only the current keyframe is evaluated, so the cost does not depend on the program length)
+    if(this->pKeyframes != nullptr){
+        auto now = millis();
 
-    // handle fading action
-    if(millis() > (unsigned long)(this->fadeTimer + this->fadeTimeOut)){
-        // reset timer reference
-        this->fadeTimer = millis();
+        if((now - this->keyframeTimer) >= this->keyframeStepTime){
+            // the next keyframe starts at the end of the current one, so the tempo is kept if the call is late
+            auto startTime = this->keyframeTimer + this->keyframeStepTime;
+            if((now - startTime) >= this->keyframeStepTime){
+                startTime = now;
+            }
 
-        // check if the red value must be changed
-        if(this->redValue != this->currentRedValue){
-            // if hard transition is requested, set the color direct
-            if(this->hardTrans){
-                this->currentRedValue = this->redValue;
-                analogWrite(this->redPin, this->currentRedValue);
+            // the fade of the keyframe is due, complete it so the next keyframe starts from the exact color
+            // (in timer driven mode the interrupt must not advance the fade at the same time)
+            noInterrupts();
+            if(this->fadeProgress < RGB_FADE_PROGRESS_COMPLETE){
+                this->applyFadeProgress(RGB_FADE_PROGRESS_COMPLETE);
             }
-            else {
-                // no hard transition -> fade
-                if(this->redValue > this->currentRedValue){
-                    this->currentRedValue++;
-                }
-                else {
-                    this->currentRedValue--;
+            interrupts();
+
+            this->keyframeIndex++;
+            if(this->keyframeIndex >= this->keyframeCount){
+                this->keyframeIndex = 0;
+                this->keyframeRunCount++;
+
+                if((this->keyframeRepeatCount != RGB_KEYFRAME_REPEAT_INFINITE) && (this->keyframeRunCount >= this->keyframeRepeatCount)){
+                    // program finished, the color of the last keyframe remains
+                    this->pKeyframes = nullptr;
                 }
-                analogWrite(this->redPin, this->currentRedValue);
+            }
+            if(this->pKeyframes != nullptr){
+                this->startKeyframe(startTime);
+                this->startFade();
             }
         }
+    }
 
-        // check if the green value must be changed
-        if(this->greenValue != this->currentGreenValue){
-            // if hard transition is requested, set the color direct
-            if(this->hardTrans){
-                this->currentGreenValue = this->greenValue;
-                analogWrite(greenPin, currentGreenValue);
-            }
-            else {
-                // no hard transition -> fade
-                if(this->greenValue > this->currentGreenValue){
-                    this->currentGreenValue++;
-                }
-                else {
-                    this->currentGreenValue--;
-                }
-                analogWrite(greenPin, currentGreenValue);
-            }
+    // handle fading action (only if not driven by the timer)
+    if(!this->timerDrivenFading && (this->fadeProgress < RGB_FADE_PROGRESS_COMPLETE)
+        && (millis() > (unsigned long)(this->fadeTimer + this->fadeTimeOut)))
+    {
+        // reset timer reference
+        this->fadeTimer = millis();
+
+        // the progress results from the elapsed time, so a delayed call does not slow down the fade
+        uint64_t progress = ((uint64_t)(this->fadeTimer - this->fadeStartTime) << 16) / this->activeFadeDuration;
+        this->applyFadeProgress((progress < RGB_FADE_PROGRESS_COMPLETE) ? (uint32_t)progress : RGB_FADE_PROGRESS_COMPLETE);
+    }
+
+    // get the time until the next action (the timers are exceeded one millisecond after the timeout)
+    auto now = millis();
+    unsigned long next = SCHEDULER_NO_DEADLINE;
+
+    if(this->tProgram != RGBColorTransitionProgram::RCTP_NO_TRANSITION){
+        auto elapsed = now - this->progTimer;
+        next = (elapsed > this->progTimeOut) ? 0 : (this->progTimeOut - elapsed + 1);
+    }
+    if(this->pKeyframes != nullptr){
+        auto elapsed = now - this->keyframeTimer;
+        unsigned long keyframeNext = (elapsed >= this->keyframeStepTime) ? 0 : (this->keyframeStepTime - elapsed);
+
+        if(keyframeNext < next){
+            next = keyframeNext;
         }
+    }
+    if(!this->timerDrivenFading && (this->fadeProgress < RGB_FADE_PROGRESS_COMPLETE)){
+        auto elapsed = now - this->fadeTimer;
+        unsigned long fadeNext = (elapsed > this->fadeTimeOut) ? 0 : (this->fadeTimeOut - elapsed + 1);
 
-        // check if the blue value must be changed
-        if(this->blueValue != this->currentBlueValue){
-            // if hard transition is requested, set the color direct
-            if(this->hardTrans){
-                this->currentBlueValue = this->blueValue;
-                analogWrite(this->bluePin, this->currentBlueValue);
-            }
-            else {
-                // no hard transition -> fade
-                if(this->blueValue > this->currentBlueValue){
-                    this->currentBlueValue++;
+        if(fadeNext < next){
+            next = fadeNext;
+        }
+    }
+    if(outputPending && (next > 1)){
+        next = 1;
+    }
+    return next;
+}
+
+static_assert(LAROOMY_MAX_RGB_ZONES <= 32, "The zones of RGBZoneControl are tracked in 32 bit masks");
+
+// the color change interval and the fade delay of the color transition programs
+static void getProgramTiming(RGBColorTransitionProgram program, unsigned long& interval, unsigned long& fadeDelay){
+    switch(program){
+        case RGBColorTransitionProgram::RCTP_SLOW_TRANSITION:
+            interval = 8000;
+            fadeDelay = 22;
+            break;
+        case RGBColorTransitionProgram::RCTP_SEMISLOW_TRANSITION:
+            interval = 6000;
+            fadeDelay = 14;
+            break;
+        case RGBColorTransitionProgram::RCTP_MEDIUM_TRANSITION:
+            interval = 4000;
+            fadeDelay = 8;
+            break;
+        case RGBColorTransitionProgram::RCTP_SEMIFAST_TRANSITION:
+            interval = 2000;
+            fadeDelay = 4;
+            break;
+        case RGBColorTransitionProgram::RCTP_FAST_TRANSITION:
+            interval = 1000;
+            fadeDelay = 1;
+            break;
+        default:
+            interval = 0;
+            fadeDelay = 0;
+            break;
+    }
+}
+
+RGBZoneControl::~RGBZoneControl(){
+    this->detachFromScheduler();
+}
+
+int RGBZoneControl::addZone(pin_size_t redPin, pin_size_t greenPin, pin_size_t bluePin, cID rgbSelectorID){
+    if(this->zoneCount >= LAROOMY_MAX_RGB_ZONES){
+        return -1;
+    }
+    auto zone = this->zoneCount;
+
+    this->pins[0][zone] = redPin;
+    this->pins[1][zone] = greenPin;
+    this->pins[2][zone] = bluePin;
+
+    for(unsigned int c = 0; c < 3; c++){
+        this->currentValues[c][zone] = 0;
+        this->fadeStartValues[c][zone] = 0;
+        this->fadeDelta[c][zone] = 0;
+    }
+    this->fadeStartTime[zone] = 0;
+    this->activeFadeDuration[zone] = 0;
+    this->boundSelectorIDs[zone] = rgbSelectorID;
+    this->programs[zone] = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
+    this->programTimers[zone] = 0;
+    this->colorIndexes[zone] = 0;
+
+    this->zoneCount++;
+
+    if(this->hasBegun){
+        for(unsigned int c = 0; c < 3; c++){
+            pinMode(this->pins[c][zone], OUTPUT);
+        }
+        this->writeZone(zone);
+    }
+    return (int)zone;
+}
+
+void RGBZoneControl::bindZone(unsigned int zone, cID rgbSelectorID){
+    if(zone < this->zoneCount){
+        this->boundSelectorIDs[zone] = rgbSelectorID;
+    }
+}
+
+void RGBZoneControl::begin(){
+    for(unsigned int zone = 0; zone < this->zoneCount; zone++){
+        for(unsigned int c = 0; c < 3; c++){
+            pinMode(this->pins[c][zone], OUTPUT);
+        }
+        this->writeZone(zone);
+    }
+
+    // create default color selection
+    if(this->colorSelection.GetCount() == 0){
+        this->colorSelection.AddItem(Colors::Red);
+        this->colorSelection.AddItem(Colors::Green);
+        this->colorSelection.AddItem(Colors::Blue);
+        this->colorSelection.AddItem(Colors::Magenta);
+        this->colorSelection.AddItem(Colors::Cyan);
+        this->colorSelection.AddItem(Colors::Yellow);
+        this->colorSelection.AddItem(Colors::Pink);
+        this->colorSelection.AddItem(Colors::Orange);
+        this->colorSelection.AddItem(Colors::Purple);
+        this->colorSelection.AddItem(Colors::White);
+    }
+    this->fadeTimer = millis();
+    this->hasBegun = true;
+}
+
+void RGBZoneControl::end(){
+    this->hasBegun = false;
+    this->fadeMask = 0;
+    this->programMask = 0;
+
+    for(unsigned int zone = 0; zone < this->zoneCount; zone++){
+        this->programs[zone] = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
+        for(unsigned int c = 0; c < 3; c++){
+            this->currentValues[c][zone] = 0;
+            analogWrite(this->pins[c][zone], 0);
+        }
+    }
+}
+
+void RGBZoneControl::changeZoneColor(unsigned int zone, uint8_t red, uint8_t green, uint8_t blue, RGBTransitionType tType){
+    if(zone >= this->zoneCount){
+        return;
+    }
+    this->programMask &= ~(1UL << zone);
+    this->programs[zone] = RGBColorTransitionProgram::RCTP_NO_TRANSITION;
+
+    this->startZoneFade(zone, red, green, blue, this->fadeTimeOut, (tType == RGBTransitionType::HARD_TRANSITION));
+    this->wakeTask();
+}
+
+void RGBZoneControl::changeZoneProgram(unsigned int zone, RGBColorTransitionProgram program, RGBTransitionType tType){
+    if(zone >= this->zoneCount){
+        return;
+    }
+    if(tType == RGBTransitionType::HARD_TRANSITION){
+        this->hardTransitionMask |= (1UL << zone);
+    }
+    else {
+        this->hardTransitionMask &= ~(1UL << zone);
+    }
+
+    if(program == RGBColorTransitionProgram::RCTP_NO_TRANSITION){
+        // the current color remains
+        this->programMask &= ~(1UL << zone);
+        this->programs[zone] = program;
+        return;
+    }
+    auto wasActive = (this->programMask & (1UL << zone)) ? true : false;
+
+    this->programs[zone] = program;
+    this->programMask |= (1UL << zone);
+    this->programTimers[zone] = millis();
+
+    // if no program was active -> set the first color immediately
+    if(!wasActive && (this->colorSelection.GetCount() > 0)){
+        unsigned long interval, fadeDelay;
+        getProgramTiming(program, interval, fadeDelay);
+
+        this->colorIndexes[zone] = 0;
+        auto color = this->colorSelection.getObjectCoreReferenceAt(0);
+        this->startZoneFade(zone, color->redPart, color->greenPart, color->bluePart, fadeDelay, (tType == RGBTransitionType::HARD_TRANSITION));
+    }
+    this->wakeTask();
+}
+
+void RGBZoneControl::zoneOff(unsigned int zone){
+    this->changeZoneColor(zone, 0, 0, 0);
+}
+
+void RGBZoneControl::applyStateChange(unsigned int zone, const RGBSelectorState& state){
+    if(state.isOn){
+        if(state.colorTransitionProgram != RGBColorTransitionProgram::RCTP_NO_TRANSITION){
+            this->changeZoneProgram(zone, state.colorTransitionProgram, state.transitionType);
+        }
+        else {
+            this->changeZoneColor(zone, state.redValue, state.greenValue, state.blueValue, state.transitionType);
+        }
+    }
+    else {
+        this->zoneOff(zone);
+    }
+}
+
+bool RGBZoneControl::applyBoundStateChange(cID rgbSelectorID, const RGBSelectorState& state){
+    bool bound = false;
+
+    for(unsigned int zone = 0; zone < this->zoneCount; zone++){
+        if(this->boundSelectorIDs[zone] == rgbSelectorID){
+            this->applyStateChange(zone, state);
+            bound = true;
+        }
+    }
+    return bound;
+}
+
+void RGBZoneControl::setCustomColorSelection(ColorCollection& colorSel){
+    if(colorSel.GetCount() > 0){
+        this->colorSelection = colorSel;
+
+        for(unsigned int zone = 0; zone < this->zoneCount; zone++){
+            this->colorIndexes[zone] = 0;
+        }
+    }
+}
+
+unsigned long RGBZoneControl::onLoop(){
+    if(!this->hasBegun){
+        return SCHEDULER_NO_DEADLINE;
+    }
+    // one time query for all zones
+    auto now = millis();
+    unsigned long next = SCHEDULER_NO_DEADLINE;
+
+    // handle the programs
+    for(uint32_t mask = this->programMask; mask != 0; mask &= (mask - 1)){
+        unsigned int zone = __builtin_ctz(mask);
+        unsigned long interval, fadeDelay;
+        getProgramTiming(this->programs[zone], interval, fadeDelay);
+
+        auto elapsed = now - this->programTimers[zone];
+        if(elapsed >= interval){
+            this->programTimers[zone] = now;
+            this->nextProgramColor(zone);
+            elapsed = 0;
+        }
+        if((interval - elapsed) < next){
+            next = interval - elapsed;
+        }
+    }
+
+    // advance all active fades in one pass
+    if(this->fadeMask != 0){
+        auto elapsed = now - this->fadeTimer;
+
+        if(elapsed >= this->fadeTimeOut){
+            this->fadeTimer = now;
+            elapsed = 0;
+
+            for(uint32_t mask = this->fadeMask; mask != 0; mask &= (mask - 1)){
+                unsigned int zone = __builtin_ctz(mask);
+
+                uint64_t progress = ((uint64_t)(now - this->fadeStartTime[zone]) << 16) / this->activeFadeDuration[zone];
+                if(progress >= RGB_FADE_PROGRESS_COMPLETE){
+                    progress = RGB_FADE_PROGRESS_COMPLETE;
+                    this->fadeMask &= ~(1UL << zone);
                 }
-                else {
-                    this->currentBlueValue--;
+                auto eased = easeProgress(this->fadeEasing, (uint32_t)progress);
+
+                for(unsigned int c = 0; c < 3; c++){
+                    this->currentValues[c][zone] =
+                        (uint8_t)(this->fadeStartValues[c][zone] + ((this->fadeDelta[c][zone] * eased + 0x8000) >> 16));
                 }
-                analogWrite(this->bluePin, this->currentBlueValue);
+                this->writeZone(zone);
             }
         }
+        if((this->fadeMask != 0) && ((this->fadeTimeOut - elapsed) < next)){
+            next = this->fadeTimeOut - elapsed;
+        }
     }
+    return next;
+}
+
+void RGBZoneControl::startZoneFade(unsigned int zone, uint8_t red, uint8_t green, uint8_t blue, unsigned long fadeDelay, bool hardTransition){
+    uint8_t targetValues[3] = { red, green, blue };
+    unsigned int maxDelta = 0;
+
+    for(unsigned int c = 0; c < 3; c++){
+        this->fadeStartValues[c][zone] = this->currentValues[c][zone];
+        this->fadeDelta[c][zone] = (int16_t)targetValues[c] - (int16_t)this->currentValues[c][zone];
+
+        unsigned int delta = (this->fadeDelta[c][zone] < 0) ? -this->fadeDelta[c][zone] : this->fadeDelta[c][zone];
+        if(delta > maxDelta){
+            maxDelta = delta;
+        }
+    }
+    // without a fixed duration, the duration results from the largest channel difference
+    unsigned long duration =
+        (this->fadeDuration > 0) ? this->fadeDuration : (maxDelta * fadeDelay);
+
+    if(hardTransition || (maxDelta == 0) || (duration == 0)){
+        for(unsigned int c = 0; c < 3; c++){
+            this->currentValues[c][zone] = targetValues[c];
+        }
+        this->fadeMask &= ~(1UL << zone);
+        this->writeZone(zone);
+    }
+    else {
+        this->fadeStartTime[zone] = millis();
+        this->activeFadeDuration[zone] = duration;
+        this->fadeMask |= (1UL << zone);
+    }
+}
+
+void RGBZoneControl::nextProgramColor(unsigned int zone){
+    if(this->colorSelection.GetCount() == 0){
+        return;
+    }
+    this->colorIndexes[zone]++;
+    if(this->colorIndexes[zone] >= this->colorSelection.GetCount()){
+        this->colorIndexes[zone] = 0;
+    }
+    unsigned long interval, fadeDelay;
+    getProgramTiming(this->programs[zone], interval, fadeDelay);
+
+    auto color = this->colorSelection.getObjectCoreReferenceAt(this->colorIndexes[zone]);
+    this->startZoneFade(zone, color->redPart, color->greenPart, color->bluePart, fadeDelay,
+        (this->hardTransitionMask & (1UL << zone)) ? true : false);
+}
+
+void RGBZoneControl::writeZone(unsigned int zone){
+    for(unsigned int c = 0; c < 3; c++){
+        auto value = this->currentValues[c][zone];
+        analogWrite(this->pins[c][zone], this->gammaCorrection ? gammaTable[value] : value);
+    }
+}
+
+bool RGBZoneControl::attachToScheduler(TaskScheduler& scheduler){
+    this->detachFromScheduler();
+
+    this->taskHandle = scheduler.addTask(&RGBZoneControl::taskFunction, this, 0);
+    if(this->taskHandle == INVALID_TASK_HANDLE){
+        return false;
+    }
+    this->pScheduler = &scheduler;
+    return true;
+}
+
+void RGBZoneControl::detachFromScheduler(){
+    if(this->pScheduler != nullptr){
+        this->pScheduler->removeTask(this->taskHandle);
+        this->pScheduler = nullptr;
+        this->taskHandle = INVALID_TASK_HANDLE;
+    }
+}
+
+void RGBZoneControl::wakeTask(){
+    if(this->pScheduler != nullptr){
+        this->pScheduler->scheduleTask(this->taskHandle, 0);
+    }
+}
+
+void RGBZoneControl::taskFunction(void* context){
+    auto pControl = reinterpret_cast<RGBZoneControl*>(context);
+    // the task is only scheduled while an output changes
+    pControl->pScheduler->scheduleTask(pControl->taskHandle, pControl->onLoop());
 }